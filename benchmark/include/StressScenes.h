@@ -0,0 +1,88 @@
+#ifndef FRUITWORK_STRESS_SCENES_H
+#define FRUITWORK_STRESS_SCENES_H
+
+#include <string>
+#include <vector>
+#include "Scene.h"
+#include "Label.h"
+#include "Rectangle.h"
+#include "ResourceManager.h"
+
+namespace benchmark
+{
+    /**
+     * A scene that puts the engine under a specific kind of load. Every component added to it is destroyed when it exits.
+     */
+    class StressScene : public fruitwork::Scene {
+    public:
+        /** @return The name of the scene, as it appears in the benchmark results. */
+        const std::string &getName() const { return name; }
+
+        bool exit() override;
+
+    protected:
+        explicit StressScene(std::string name) : name(std::move(name)) {}
+
+        /** A texture shared by all sprites of the scene, released on exit. */
+        fruitwork::ResourceManager::TextureHandle texture;
+
+        /** The amount of frames since the scene was entered. */
+        int frame = 0;
+
+    private:
+        std::string name;
+    };
+
+    /** 10 000 sprites sharing one texture, drawn every frame. */
+    class SpriteStressScene : public StressScene {
+    public:
+        SpriteStressScene() : StressScene("sprites") {}
+
+        bool enter() override;
+    };
+
+    /** 1 000 labels, a tenth of which change their text every frame. */
+    class LabelStressScene : public StressScene {
+    public:
+        LabelStressScene() : StressScene("labels") {}
+
+        bool enter() override;
+
+        void update() override;
+
+    private:
+        std::vector<fruitwork::Label *> labels;
+    };
+
+    /** 5 000 sprites with physics bodies colliding with each other and the screen. */
+    class PhysicsStressScene : public StressScene {
+    public:
+        PhysicsStressScene() : StressScene("physics") {}
+
+        bool enter() override;
+    };
+
+    /** A confetti cannon firing 50 000 pieces. */
+    class ConfettiStressScene : public StressScene {
+    public:
+        ConfettiStressScene() : StressScene("confetti") {}
+
+        bool enter() override;
+    };
+
+    /** Long chains of anchored children whose roots move every frame, invalidating every layout below them. */
+    class HierarchyStressScene : public StressScene {
+    public:
+        HierarchyStressScene() : StressScene("hierarchy") {}
+
+        bool enter() override;
+
+        void update() override;
+
+    private:
+        std::vector<fruitwork::Rectangle *> roots;
+    };
+
+} // benchmark
+
+#endif //FRUITWORK_STRESS_SCENES_H
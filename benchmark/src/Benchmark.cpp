@@ -0,0 +1,161 @@
+#include <SDL.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "System.h"
+#include "Session.h"
+#include "StressScenes.h"
+#include "Profiler.h"
+#include "RenderQueue.h"
+
+using namespace fruitwork;
+
+namespace benchmark
+{
+    /** The frame times of a single phase, in milliseconds. */
+    struct Phase {
+        const char *name;
+        std::vector<float> samples;
+    };
+
+    /** Nearest-rank percentile of a sorted list. */
+    static float percentile(const std::vector<float> &sorted, float p)
+    {
+        if (sorted.empty())
+            return 0;
+
+        int rank = (int) std::ceil(p / 100.0f * sorted.size());
+        return sorted[std::max(rank, 1) - 1];
+    }
+
+    static void writePhase(FILE *file, Phase &phase, bool last)
+    {
+        std::vector<float> &samples = phase.samples;
+        std::sort(samples.begin(), samples.end());
+
+        double sum = 0;
+        for (float sample: samples)
+            sum += sample;
+
+        std::fprintf(file, "        \"%s\": {\"mean\": %.4f, \"p50\": %.4f, \"p90\": %.4f, \"p99\": %.4f, \"max\": %.4f}%s\n",
+                     phase.name, samples.empty() ? 0.0 : sum / samples.size(),
+                     percentile(samples, 50), percentile(samples, 90), percentile(samples, 99),
+                     samples.empty() ? 0.0f : samples.back(), last ? "" : ",");
+    }
+
+} // benchmark
+
+/**
+ * Runs every stress scene for a fixed amount of frames and writes the frame time percentiles of every phase as JSON.
+ * Usage: benchmark [frames] [output file] [trace file]
+ * If a trace file is given, the whole run is recorded with the profiler. This needs a build with FRUITWORK_PROFILING.
+ * For reproducible results run it headless, with SDL_VIDEODRIVER=dummy, SDL_RENDER_DRIVER=software and SDL_AUDIODRIVER=dummy.
+ */
+int main(int argc, char *argv[])
+{
+    using namespace benchmark;
+
+    int frames = argc > 1 ? std::atoi(argv[1]) : 600;
+    const char *outputPath = argc > 2 ? argv[2] : "benchmark.json";
+    const char *tracePath = argc > 3 ? argv[3] : nullptr;
+
+    if (frames <= 0)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Invalid frame count: %s", argv[1]);
+        return 1;
+    }
+
+    const char *videoDriver = SDL_GetCurrentVideoDriver();
+    if (videoDriver == nullptr || std::strcmp(videoDriver, "dummy") != 0)
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Not running headless, results depend on the display. Set SDL_VIDEODRIVER=dummy.");
+
+    SDL_RendererInfo rendererInfo = {};
+    SDL_GetRendererInfo(sys.getRenderer(), &rendererInfo);
+
+    SpriteStressScene spriteScene;
+    LabelStressScene labelScene;
+    PhysicsStressScene physicsScene;
+    ConfettiStressScene confettiScene;
+    HierarchyStressScene hierarchyScene;
+
+    std::vector<StressScene *> scenes = {&spriteScene, &labelScene, &physicsScene, &confettiScene, &hierarchyScene};
+
+    // declared after the scenes, so it is destroyed before them
+    Session session;
+    session.setFrameLimit(frames);
+    session.setFramePacing(false);
+
+    FILE *file = std::fopen(outputPath, "w");
+    if (file == nullptr)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Unable to open %s for writing", outputPath);
+        return 1;
+    }
+
+    if (tracePath != nullptr)
+    {
+#ifndef FRUITWORK_PROFILING
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Built without FRUITWORK_PROFILING, the trace will be empty.");
+#endif
+        Profiler::getInstance()->start();
+    }
+
+    std::fprintf(file, "{\n  \"frames\": %d,\n  \"videoDriver\": \"%s\",\n  \"renderer\": \"%s\",\n  \"scenes\": [\n",
+                 frames, videoDriver != nullptr ? videoDriver : "", rendererInfo.name != nullptr ? rendererInfo.name : "");
+
+    for (int i = 0; i < (int) scenes.size(); i++)
+    {
+        StressScene *scene = scenes[i];
+
+        Phase events = {"events"}, update = {"update"}, physics = {"physics"}, draw = {"draw"}, present = {"present"}, total = {"total"};
+        double drawCalls = 0;
+        session.setFrameListener([&](const Session::FrameTimings &timings)
+                                 {
+                                     events.samples.push_back(timings.events * 1000);
+                                     update.samples.push_back(timings.update * 1000);
+                                     physics.samples.push_back(timings.physics * 1000);
+                                     draw.samples.push_back(timings.draw * 1000);
+                                     present.samples.push_back(timings.present * 1000);
+                                     total.samples.push_back((timings.events + timings.update + timings.physics + timings.draw + timings.present) * 1000);
+                                     drawCalls += RenderQueue::getInstance()->getDrawCallCount();
+                                 });
+
+        SDL_Log("Running %s for %d frames...", scene->getName().c_str(), frames);
+        session.run(scene);
+
+        std::fprintf(file, "    {\n      \"name\": \"%s\",\n      \"drawCalls\": %.1f,\n      \"phases\": {\n",
+                     scene->getName().c_str(), total.samples.empty() ? 0.0 : drawCalls / total.samples.size());
+        writePhase(file, events, false);
+        writePhase(file, update, false);
+        writePhase(file, physics, false);
+        writePhase(file, draw, false);
+        writePhase(file, present, false);
+        writePhase(file, total, true);
+        std::fprintf(file, "      }\n    }%s\n", i + 1 < (int) scenes.size() ? "," : "");
+
+        SDL_Log("%s: p50 %.3f ms, p99 %.3f ms", scene->getName().c_str(), percentile(total.samples, 50), percentile(total.samples, 99));
+    }
+
+    std::fprintf(file, "  ]\n}\n");
+    std::fclose(file);
+
+    if (tracePath != nullptr)
+    {
+        Profiler::getInstance()->stop();
+        Profiler::getInstance()->writeTrace(tracePath);
+    }
+
+    session.setFrameListener(nullptr);
+
+    // the session only unloads a scene when it changes to the next one
+    scenes.back()->exit();
+    scenes.back()->deleteComponents();
+
+    SDL_Log("Results written to %s", outputPath);
+
+    return 0;
+}
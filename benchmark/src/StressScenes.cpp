@@ -0,0 +1,154 @@
+#include "StressScenes.h"
+#include <random>
+#include "System.h"
+#include "Sprite.h"
+#include "ConfettiCannon.h"
+#include "ResourceManager.h"
+
+using namespace fruitwork;
+
+namespace benchmark
+{
+    // fixed seed, every run places the components in the same spots
+    static std::mt19937 generator(1234);
+
+    static int randomInt(int min, int max)
+    {
+        return std::uniform_int_distribution<int>(min, max)(generator);
+    }
+
+    bool StressScene::exit()
+    {
+        for (Component *c: getComponents())
+            removeComponent(c, true);
+
+        texture = nullptr;
+        frame = 0;
+
+        return true;
+    }
+
+    bool SpriteStressScene::enter()
+    {
+        texture = ResourceManager::getTexture(ResourceManager::getTexturePath("fruit-orange.png"));
+
+        std::vector<Component *> sprites;
+        sprites.reserve(10000);
+
+        for (int i = 0; i < 10000; i++)
+        {
+            Sprite *sprite = Sprite::getInstance(randomInt(0, 1152), randomInt(0, 852), 48, 48, texture.get());
+            sprite->setColorMod({(Uint8) randomInt(0, 255), (Uint8) randomInt(0, 255), (Uint8) randomInt(0, 255), 255});
+            sprites.push_back(sprite);
+        }
+
+        addComponents(sprites);
+
+        return true;
+    }
+
+    bool LabelStressScene::enter()
+    {
+        labels.clear();
+        labels.reserve(1000);
+
+        for (int i = 0; i < 1000; i++)
+        {
+            Label *label = Label::getInstance((i % 10) * 120, (i / 10) * 9, 120, 24, "Label " + std::to_string(i));
+            label->setFontSize(16);
+            labels.push_back(label);
+        }
+
+        addComponents(std::vector<Component *>(labels.begin(), labels.end()));
+
+        return true;
+    }
+
+    void LabelStressScene::update()
+    {
+        // a tenth of the labels change every frame, like scores and timers would
+        for (int i = frame % 10; i < (int) labels.size(); i += 10)
+            labels[i]->setText(std::to_string(frame) + " / " + std::to_string(i));
+
+        frame++;
+    }
+
+    bool PhysicsStressScene::enter()
+    {
+        texture = ResourceManager::getTexture(ResourceManager::getTexturePath("star.png"));
+
+        std::vector<Component *> sprites;
+        sprites.reserve(5000);
+
+        for (int i = 0; i < 5000; i++)
+        {
+            Sprite *sprite = Sprite::getInstance(randomInt(0, 1176), randomInt(0, 876), 24, 24, texture.get());
+
+            PhysicsBody *body = PhysicsBody::getInstance(sprite->getRect());
+            body->setScreenCollision(true);
+            body->setObjCollision(true);
+            body->setVelocity((float) randomInt(-200, 200), (float) randomInt(-200, 200));
+            sprite->setPhysicsBody(body);
+
+            sprites.push_back(sprite);
+        }
+
+        addComponents(sprites);
+
+        return true;
+    }
+
+    bool ConfettiStressScene::enter()
+    {
+        ConfettiCannon *cannon = ConfettiCannon::getInstance(1200 / 2, 900 / 2, 24, 24, ResourceManager::getTexturePath("star.png"));
+        addComponent(cannon);
+
+        cannon->fire(0, 360, 50000, 1000);
+
+        return true;
+    }
+
+    bool HierarchyStressScene::enter()
+    {
+        static const Anchor anchors[] = {Anchor::TOP_LEFT, Anchor::CENTER, Anchor::BOTTOM_RIGHT, Anchor::STRETCH, Anchor::TOP_STRETCH};
+
+        roots.clear();
+        std::vector<Component *> rectangles;
+
+        // 32 chains of 128 components, every component anchored to the previous one
+        for (int chain = 0; chain < 32; chain++)
+        {
+            Rectangle *root = Rectangle::getInstance(chain * 36, 0, 32, 800, {0, 0, 0, 30});
+            roots.push_back(root);
+            rectangles.push_back(root);
+
+            Component *parent = root;
+            for (int depth = 0; depth < 128; depth++)
+            {
+                Rectangle *child = Rectangle::getInstance(1, 2, 30, 760, {(Uint8) (depth * 2), 128, (Uint8) (chain * 8), 30});
+                child->setAnchorAndPivot(anchors[depth % 5]);
+                parent->addChild(child);
+
+                rectangles.push_back(child);
+                parent = child;
+            }
+        }
+
+        addComponents(rectangles);
+
+        return true;
+    }
+
+    void HierarchyStressScene::update()
+    {
+        for (Rectangle *root: roots)
+        {
+            SDL_Rect rect = root->getRect();
+            rect.y = frame % 100;
+            root->setRect(rect);
+        }
+
+        frame++;
+    }
+
+} // benchmark
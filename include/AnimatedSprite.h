@@ -1,12 +1,17 @@
 #ifndef FRUITWORK_ANIMATED_SPRITE_H
 #define FRUITWORK_ANIMATED_SPRITE_H
 
-#include <vector>
 #include "Sprite.h"
+#include "AnimationClip.h"
 
 namespace fruitwork
 {
 
+    /**
+     * A sprite playing an AnimationClip.
+     * The shown frame follows from the time since the animation started, so sprites playing the same clip stay in sync
+     * unless restarted, and a sprite only changes its region when the frame changes.
+     */
     class AnimatedSprite : public Sprite {
     public:
         /**
@@ -21,21 +26,40 @@ namespace fruitwork
          */
         static AnimatedSprite *getInstance(int x, int y, int w, int h, const std::string &animationPath, Uint32 animationSpeed);
 
+        /**
+         * Get an instance of the AnimatedSprite class with its frames from the texture atlas.
+         * @param animationName The name of the animation images, relative to the images directory, e.g. pippi-{n}.png.
+         * If the frames are not in the atlas, they are loaded from the images directory instead.
+         * @param animationSpeed The speed (frame rate) of the animation, in milliseconds.
+         */
+        static AnimatedSprite *getAtlasInstance(int x, int y, int w, int h, const std::string &animationName, Uint32 animationSpeed);
+
+        /**
+         * Get an instance of the AnimatedSprite class playing a clip, e.g. a spritesheet from AnimationClip::getSheetInstance.
+         */
+        static AnimatedSprite *getInstance(int x, int y, int w, int h, const AnimationClip::Handle &clip);
+
         void update() override;
 
-        ~AnimatedSprite() override;
+        /** Play another clip, from the time the animation started. */
+        void setClip(const AnimationClip::Handle &newClip);
+
+        const AnimationClip::Handle &getClip() const { return clip; }
+
+        /** Play the animation from its first frame, out of sync with sprites that were not restarted at the same time. */
+        void restart();
 
     protected:
-        AnimatedSprite(int x, int y, int w, int h, const std::string &animationPath, Uint32 animationSpeed);
+        AnimatedSprite(int x, int y, int w, int h, AnimationClip::Handle clip);
 
     private:
-        std::vector<SDL_Texture *> frames;
-        int frameCount = 0;
-        std::string animationName;
-        Uint32 animationSpeed;
+        AnimationClip::Handle clip;
+
+        /** The ticks the animation started at, 0 for the shared clock every sprite starts on. */
+        Uint64 startTime = 0;
 
-        int frame = 0;
-        int lastFrame = 0;
+        /** The frame currently shown, -1 for none. */
+        int frame = -1;
     };
 
 } // fruitwork
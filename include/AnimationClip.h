@@ -0,0 +1,99 @@
+#ifndef FRUITWORK_ANIMATION_CLIP_H
+#define FRUITWORK_ANIMATION_CLIP_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <unordered_map>
+#include <SDL.h>
+#include "TextureAtlas.h"
+
+namespace fruitwork
+{
+
+    /**
+     * The frames of an animation and how long each of them is shown.
+     * Clips are cached by where their frames come from, so every AnimatedSprite of the same animation shares one clip,
+     * and creating another one is a single lookup instead of finding and loading its frames again.
+     */
+    class AnimationClip {
+    public:
+        /** A clip shared by every sprite playing it. It is released when the last handle is. */
+        using Handle = std::shared_ptr<const AnimationClip>;
+
+        struct Frame {
+            TextureAtlas::Region region;
+
+            /** How long the frame is shown, in milliseconds. */
+            Uint32 duration;
+        };
+
+        /**
+         * Get a clip of numbered image files.
+         * @param animationPath The path of the frames, in the format res/img/texture-{n}.png. {n} is replaced with the frame number, starting at 0.
+         * @param frameDuration How long every frame is shown, in milliseconds.
+         */
+        static Handle getInstance(const std::string &animationPath, Uint32 frameDuration);
+
+        /**
+         * Get a clip of numbered images in the texture atlas.
+         * @param animationName The name of the frames, relative to the images directory, e.g. pippi-{n}.png.
+         * If the frames are not in the atlas, they are loaded from the images directory instead.
+         * @param frameDuration How long every frame is shown, in milliseconds.
+         */
+        static Handle getAtlasInstance(const std::string &animationName, Uint32 frameDuration);
+
+        /**
+         * Get a clip of a spritesheet, a grid of equally sized frames in one image, read left to right and top to bottom.
+         * @param imageName The name of the sheet, relative to the images directory. It is taken from the texture atlas if it was packed.
+         * @param columns The amount of frames in a row.
+         * @param rows The amount of rows.
+         * @param frameDurations How long each frame is shown, in milliseconds. There is a frame for every duration.
+         */
+        static Handle getSheetInstance(const std::string &imageName, int columns, int rows, const std::vector<Uint32> &frameDurations);
+
+        /**
+         * Get a clip of a spritesheet where every frame is shown equally long.
+         * @param frameCount The amount of frames, the last row does not have to be full.
+         * @see getSheetInstance
+         */
+        static Handle getSheetInstance(const std::string &imageName, int columns, int rows, int frameCount, Uint32 frameDuration);
+
+        /** Create a clip of frames from anywhere. It is not cached. */
+        static Handle create(std::vector<Frame> frames);
+
+        /** Forget the clips no one holds anymore. Called on every scene change and when the system is low on memory. */
+        static void releaseUnused();
+
+        /**
+         * @param time The time since the animation started, in milliseconds. The animation loops.
+         * @return The index of the frame shown at the time.
+         */
+        int getFrameAt(Uint64 time) const;
+
+        const Frame &getFrame(int index) const { return frames[index]; }
+
+        int getFrameCount() const { return (int) frames.size(); }
+
+        /** @return The time one loop of the animation takes, in milliseconds. */
+        Uint64 getLength() const { return frameEnds.empty() ? 0 : frameEnds.back(); }
+
+        explicit AnimationClip(std::vector<Frame> frames);
+
+    private:
+        std::vector<Frame> frames;
+
+        /** The time every frame ends at, since the start of the animation. */
+        std::vector<Uint64> frameEnds;
+
+        /** Clips by where their frames come from. Entries expire when the last handle is released. */
+        static std::unordered_map<std::string, std::weak_ptr<const AnimationClip>> clips;
+
+        /** @return The cached clip of a key, loading its frames only if no one holds it already. */
+        static Handle getCached(const std::string &key, const std::function<std::vector<Frame>()> &loadFrames);
+    };
+
+} // fruitwork
+
+#endif //FRUITWORK_ANIMATION_CLIP_H
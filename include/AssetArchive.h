@@ -0,0 +1,107 @@
+#ifndef FRUITWORK_ASSET_ARCHIVE_H
+#define FRUITWORK_ASSET_ARCHIVE_H
+
+#include <string>
+#include <SDL.h>
+
+namespace fruitwork
+{
+
+    /**
+     * Every resource of the engine and the project packed into a single file, mapped into memory once at startup.
+     * Files are found through a hash table stored in the archive, and read straight from the mapping without copying them.
+     * Built by tools/AssetPacker.cpp (make pack). Without an archive, every file is opened from the resources directory.
+     *
+     * The format, all numbers little endian:
+     * - Header
+     * - Slot[slotCount], an open addressing table by the hash of the path, 0 for an empty slot and the entry index + 1 otherwise
+     * - Entry[entryCount]
+     * - the paths of the entries, not terminated
+     * - the contents of the entries, each aligned to 16 bytes
+     */
+    class AssetArchive {
+    public:
+        static const Uint32 MAGIC = 0x4b505746; // "FWPK"
+        static const Uint32 VERSION = 1;
+
+        struct Header {
+            Uint32 magic;
+            Uint32 version;
+            Uint32 entryCount;
+
+            /** A power of two, at least twice the amount of entries so probes stay short. */
+            Uint32 slotCount;
+        };
+
+        using Slot = Uint32;
+
+        struct Entry {
+            Uint64 hash;
+
+            /** Where the contents start, from the start of the archive. */
+            Uint64 offset;
+            Uint64 size;
+
+            /** Where the path starts, from the start of the archive. */
+            Uint32 pathOffset;
+            Uint32 pathLength;
+        };
+
+        /** FNV-1a of a path as it is passed to the ResourceManager, e.g. "resources/images/apple.png". */
+        static Uint64 hash(const char *path, size_t length)
+        {
+            Uint64 hash = 0xcbf29ce484222325;
+            for (size_t i = 0; i < length; i++)
+            {
+                hash ^= (Uint8) path[i];
+                hash *= 0x100000001b3;
+            }
+
+            return hash;
+        }
+
+        /**
+         * resources.pak in the working directory, next to the resources directory, mapped on first use.
+         * Lookups are read only and may happen on any thread.
+         */
+        static AssetArchive *getInstance();
+
+        /** @return If an archive was found and mapped. */
+        bool isOpen() const { return data != nullptr; }
+
+        /** @return If a file is in the archive. */
+        bool contains(const std::string &path) const { return find(path) != nullptr; }
+
+        /**
+         * Open a file in the archive.
+         * @param path The path of the file, e.g. from ResourceManager::getTexturePath.
+         * @return A read only stream over the mapped contents, nullptr if the file is not in the archive.
+         */
+        SDL_RWops *open(const std::string &path) const;
+
+        /** @return The amount of files in the archive. */
+        int getFileCount() const { return header.entryCount; }
+
+    private:
+        AssetArchive() = default;
+
+        /** Create the archive and map it, if there is one. */
+        static AssetArchive *create();
+
+        /** Map an archive and check its header, leaves the archive closed if it is missing or invalid. */
+        bool map(const char *archivePath);
+
+        const Entry *find(const std::string &path) const;
+
+        /** The mapped archive, kept until the process exits. */
+        const Uint8 *data = nullptr;
+        size_t length = 0;
+
+        Header header{};
+        const Slot *slots = nullptr;
+        const Entry *entries = nullptr;
+    };
+
+} // fruitwork
+
+#endif //FRUITWORK_ASSET_ARCHIVE_H
@@ -0,0 +1,142 @@
+#ifndef FRUITWORK_ASSET_LOADER_H
+#define FRUITWORK_ASSET_LOADER_H
+
+#include <string>
+#include <memory>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <SDL.h>
+#include <SDL_mixer.h>
+#include "ResourceManager.h"
+
+namespace fruitwork
+{
+
+    /**
+     * Loads assets without blocking the frame.
+     * Images and sounds are decoded on worker threads. What has to happen on the main thread, creating textures and opening fonts,
+     * is done by update() at the start of every frame, for at most the frame budget, so a scene can keep drawing a progress bar
+     * or placeholders while its assets stream in.
+     */
+    class AssetLoader {
+    public:
+        /** A sound loaded by the loader, shared with ResourceManager::getSound. */
+        using SoundHandle = ResourceManager::SoundHandle;
+
+        /**
+         * An asset that is still loading. It is filled in on the main thread, so checking it from the main thread needs no locking.
+         * @tparam T The handle of the asset.
+         */
+        template<typename T>
+        class Pending {
+        public:
+            /** @return true once the asset is loaded, or failed to load. */
+            bool isReady() const { return ready; }
+
+            /** @return The asset, empty until it is ready or if it failed to load. */
+            const T &get() const { return value; }
+
+        private:
+            friend class AssetLoader;
+
+            bool ready = false;
+            T value;
+            std::function<void(const T &)> onLoaded;
+        };
+
+        template<typename T>
+        using Request = std::shared_ptr<Pending<T>>;
+
+        /** @return The loader, its worker threads start on the first request. */
+        static AssetLoader *getInstance();
+
+        AssetLoader(const AssetLoader &) = delete;
+
+        AssetLoader &operator=(const AssetLoader &) = delete;
+
+        /**
+         * Load a texture through the ResourceManager cache. The request keeps the texture loaded.
+         * @param path The path of the image, e.g. from ResourceManager::getTexturePath.
+         * @param onLoaded Called on the main thread when the texture is ready, with an empty handle if it failed to load.
+         */
+        Request<ResourceManager::TextureHandle> loadTexture(const std::string &path,
+                                                            std::function<void(const ResourceManager::TextureHandle &)> onLoaded = nullptr);
+
+        /**
+         * Open a font through the ResourceManager cache. Fonts are opened on the main thread, within the frame budget.
+         * @see fruitwork::ResourceManager::getFont
+         */
+        Request<ResourceManager::FontHandle> loadFont(const std::string &path, int size, int style = TTF_STYLE_NORMAL,
+                                                      std::function<void(const ResourceManager::FontHandle &)> onLoaded = nullptr);
+
+        /**
+         * Decode a sound.
+         * @param path The path of the sound, e.g. from ResourceManager::getAudioPath.
+         */
+        Request<SoundHandle> loadSound(const std::string &path, std::function<void(const SoundHandle &)> onLoaded = nullptr);
+
+        /**
+         * Finish decoded assets, until the frame budget is used up. Called by the session at the start of every frame.
+         * At least one asset is finished every frame, so a budget too small for an asset only slows loading down.
+         */
+        void update();
+
+        /** @param ms The time update may spend per frame, in milliseconds. */
+        void setFrameBudget(Uint32 ms) { this->frameBudget = ms; }
+
+        Uint32 getFrameBudget() const { return frameBudget; }
+
+        /** @return The amount of requested assets that are not ready yet. */
+        int getPendingCount() const { return requested - finished; }
+
+        /** @return How much of what was requested since the loader was last idle is ready, 0 to 1. */
+        float getProgress() const { return requested == 0 ? 1 : (float) finished / (float) requested; }
+
+        /** Stop the worker threads, dropping what is still queued. Called by the system before SDL shuts down. */
+        void shutdown();
+
+    private:
+        AssetLoader() = default;
+
+        /** A request, decoded on a worker thread and finished on the main thread. */
+        struct Job {
+            /** Runs on a worker thread, may be empty. */
+            std::function<void()> decode;
+
+            /** Runs on the main thread, after decode. */
+            std::function<void()> finish;
+        };
+
+        std::vector<std::thread> workers;
+
+        std::mutex mutex;
+        std::condition_variable jobAvailable;
+        bool stopping = false;
+
+        /** Jobs waiting for a worker, and jobs waiting for the main thread. Both guarded by the mutex. */
+        std::deque<std::shared_ptr<Job>> decodeQueue;
+        std::deque<std::shared_ptr<Job>> finishQueue;
+
+        Uint32 frameBudget = 4;
+
+        /** Requests since the loader was last idle, and how many of them are ready. Main thread only. */
+        int requested = 0;
+        int finished = 0;
+
+        /** Queue a job, starting the workers if they are not running yet. */
+        void enqueue(const std::shared_ptr<Job> &job);
+
+        void runWorker();
+
+        /** Complete a request on the main thread. */
+        template<typename T>
+        void complete(Pending<T> &pending, T value);
+    };
+
+} // fruitwork
+
+#endif //FRUITWORK_ASSET_LOADER_H
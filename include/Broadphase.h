@@ -0,0 +1,67 @@
+#ifndef FRUITWORK_BROADPHASE_H
+#define FRUITWORK_BROADPHASE_H
+
+#include <SDL.h>
+#include <vector>
+#include <unordered_map>
+#include "PhysicsBody.h"
+#include "ComponentView.h"
+
+namespace fruitwork
+{
+    /**
+     * A uniform grid (spatial hash) of physics bodies, used to find which bodies might collide without testing every pair.
+     * Only bodies with object collision enabled are tracked.
+     */
+    class Broadphase {
+    public:
+        struct Pair {
+            PhysicsBody *a;
+            PhysicsBody *b;
+        };
+
+        /**
+         * @param cellSize The width and height of a grid cell in pixels. Should be around the size of a typical body.
+         */
+        explicit Broadphase(int cellSize = 128);
+
+        /**
+         * Rebuild the grid from the physics bodies of the given components.
+         * @param components The components whose bodies should be tracked.
+         */
+        void rebuild(const ComponentView &components);
+
+        /**
+         * Find all pairs of tracked bodies whose rects overlap. Each pair is reported exactly once.
+         * @return The overlapping pairs. The list is reused and only valid until the next call.
+         */
+        const std::vector<Pair> &findPairs();
+
+        void setCellSize(int size);
+
+        int getCellSize() const { return cellSize; }
+
+    private:
+        int cellSize;
+
+        std::vector<PhysicsBody *> bodies;
+
+        /** Indices into bodies, per cell. Cells are kept between rebuilds to reuse their memory. */
+        std::unordered_map<Sint64, std::vector<int>> cells;
+
+        /** The keys of all cells that contain at least one body. */
+        std::vector<Sint64> occupiedCells;
+
+        std::vector<Pair> pairs;
+
+        int cellCoordinate(int position) const;
+
+        static Sint64 cellKey(int cellX, int cellY)
+        {
+            return static_cast<Sint64>(static_cast<Uint64>(static_cast<Uint32>(cellX)) << 32 | static_cast<Uint32>(cellY));
+        }
+    };
+
+} // fruitwork
+
+#endif //FRUITWORK_BROADPHASE_H
@@ -7,6 +7,8 @@
 #include <SDL_mixer.h>
 #include <SDL_ttf.h>
 #include "Component.h"
+#include "ResourceManager.h"
+#include "GlyphAtlas.h"
 
 namespace fruitwork
 {
@@ -39,6 +41,8 @@ namespace fruitwork
 
         void draw() const override;
 
+        bool isDrawBatched() const override { return true; }
+
         void update() override;
 
         void setTextColor(const SDL_Color &color);
@@ -62,7 +66,7 @@ namespace fruitwork
         bool isDown = false;
 
         SDL_Color buttonColor = {255, 255, 255, 255};
-        Mix_Chunk *clickSound, *hoverSound;
+        ResourceManager::SoundHandle clickSound, hoverSound;
 
         std::function<void(Button*)> onClick = nullptr;
 
@@ -70,11 +74,9 @@ namespace fruitwork
 
     private:
         std::string text;
-        SDL_Texture *textTexture;
-        SDL_Texture *buttonTextureLeft, *buttonTextureMiddle, *buttonTextureRight;
+        GlyphAtlas::TextLayout textLayout;
+        ResourceManager::TextureHandle buttonTextureLeft, buttonTextureMiddle, buttonTextureRight;
         SDL_Color textColor = {0, 0, 0, 255};
-
-        static TTF_Font *font;
     };
 
 } // fruitwork
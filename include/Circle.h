@@ -6,18 +6,25 @@
 namespace fruitwork
 {
 
+    /** A circle filling its rect, an ellipse if the rect is stretched. */
     class Circle : public Shape {
     public:
+        /**
+         * @param x The left of the circle.
+         * @param y The top of the circle.
+         * @param r The radius, the circle is 2 * r wide and high.
+         */
         static Circle *getInstance(int x, int y, int r, SDL_Color c);
 
-        void draw() const override;
+        /** Resize the circle, keeping its top left in place. */
+        void setRadius(int r);
+
+        int getRadius() const { return width() / 2; }
 
     protected:
         Circle(int x, int y, int r, SDL_Color c);
 
-    private:
-        int radius;
-        int centerX, centerY;
+        void buildOutline(int w, int h, std::vector<SDL_FPoint> &outline) const override;
     };
 
 } // fruitwork
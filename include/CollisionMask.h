@@ -0,0 +1,77 @@
+#ifndef FRUITWORK_COLLISION_MASK_H
+#define FRUITWORK_COLLISION_MASK_H
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <unordered_map>
+#include <SDL.h>
+
+namespace fruitwork
+{
+
+    /**
+     * One bit per pixel of an image, set where the pixel is more opaque than a threshold.
+     * Two masks are tested for overlap 64 pixels at a time, by shifting and ANDing the words of their rows.
+     */
+    class CollisionMask {
+    public:
+        /** A mask shared by every sprite of the same image and threshold. */
+        using Handle = std::shared_ptr<const CollisionMask>;
+
+        /**
+         * Get the mask of an image, building it only if no one else holds it already.
+         * The pixels of the image are only held while the mask is built.
+         * @param path The path of the image, e.g. from ResourceManager::getTexturePath.
+         * @param alpha Pixels with an alpha at or below this are transparent.
+         * @return The mask, empty if the image could not be loaded.
+         */
+        static Handle getInstance(const std::string &path, Uint8 alpha);
+
+        /** Forget the masks no one holds anymore. Called on every scene change and when the system is low on memory. */
+        static void releaseUnused();
+
+        /**
+         * @return A copy of the mask stretched to a size, sampling the nearest pixel.
+         * A sprite drawn at another size than its image tests with a scaled copy, so its bits line up with the screen.
+         */
+        Handle scaled(int w, int h) const;
+
+        /**
+         * Check if two masks have an opaque pixel at the same position.
+         * @param a The first mask, its top left at aPosition.
+         * @param b The second mask, its top left at bPosition.
+         */
+        static bool overlaps(const CollisionMask &a, SDL_Point aPosition, const CollisionMask &b, SDL_Point bPosition);
+
+        int width() const { return w; }
+
+        int height() const { return h; }
+
+        Uint8 getAlpha() const { return alpha; }
+
+        bool isOpaque(int x, int y) const { return (bits[y * wordsPerRow + x / 64] >> (x % 64)) & 1; }
+
+        CollisionMask(int w, int h, Uint8 alpha);
+
+    private:
+        /** @return 64 bits of a row starting at column x, bits past the end of the row are 0. */
+        Uint64 getBits(int y, int x) const;
+
+        int w;
+        int h;
+        Uint8 alpha;
+
+        /** Words per row, one more than needed so reading a word at any column of the row stays in bounds. */
+        int wordsPerRow;
+
+        /** The bits by row, the lowest bit of a word is its leftmost pixel. */
+        std::vector<Uint64> bits;
+
+        /** Masks by path and threshold. Entries expire when the last handle is released. */
+        static std::unordered_map<std::string, std::weak_ptr<const CollisionMask>> masks;
+    };
+
+} // fruitwork
+
+#endif //FRUITWORK_COLLISION_MASK_H
@@ -4,6 +4,7 @@
 #include <SDL.h>
 #include <vector>
 #include "PhysicsBody.h"
+#include "ComponentView.h"
 
 namespace fruitwork
 {
@@ -62,6 +63,9 @@ namespace fruitwork
         /** Called when a key is released. */
         virtual void onKeyUp(const SDL_Event &) {};
 
+        /** Called when the mouse wheel is scrolled. The mouse does not have to be over the component. */
+        virtual void onMouseWheel(const SDL_Event &) {};
+
         /** Called when text input is received. This is not the same as key down. */
         virtual void onTextInput(const SDL_Event &) {};
 
@@ -74,14 +78,29 @@ namespace fruitwork
          */
         virtual void draw() const = 0;
 
+        /**
+         * @return true if the component only draws through the RenderQueue, or flushes it before drawing directly.
+         * The queue is flushed before drawing any other component, so it is drawn over everything drawn before it.
+         */
+        virtual bool isDrawBatched() const { return false; }
+
         /** Update is called every frame. */
         virtual void update() {};
 
         /**
-         * Update is called every frame.
-         * @param elapsedTime The time in seconds since the last frame.
+         * Update is called at a fixed rate, zero or more times per frame.
+         * @param elapsedTime The time in seconds of a simulation step.
+         * @see fruitwork::Session::setSimulationRate
          */
         virtual void update(float elapsedTime);
+        /**
+         * Called once per frame after the simulation has been stepped, right before draw.
+         * Components driven by a physics body move their rect between the last two simulation steps here,
+         * so movement stays smooth when the frame rate and the simulation rate differ.
+         * @param alpha How far between the previous and the current simulation step to draw, 0 to 1.
+         */
+        virtual void interpolate(float alpha);
+
         /**
          * Start is called when the component is added to a session.
          */
@@ -105,17 +124,48 @@ namespace fruitwork
         /**
          * Sets the rect of the component. This will also update the local rect.
          */
-        void setRect(const SDL_Rect &r) { rect = r; }
+        void setRect(const SDL_Rect &r)
+        {
+            if (SDL_RectEquals(&r, &rect))
+                return;
+
+            rect = r;
+            invalidateTransform();
+        }
 
         int zIndex() const { return z; }
 
         /**
          * Set the z-index of the component. The z-index determines the order in which components are drawn and updated.
-         * Changing the z-index after the component has been added to a session or scene has no effect.
+         * Changing the z-index after the component has been added to a session or scene takes effect at the end of the frame.
          * If two components have the same z-index, the order in which they are drawn and updated is the order in which they were added.
          * @param zIndex The z-index of the component.
          */
-        void setZIndex(int zIndex) { z = zIndex; }
+        void setZIndex(int zIndex)
+        {
+            if (z == zIndex)
+                return;
+
+            z = zIndex;
+            zIndexGeneration++;
+        }
+
+        /** @return A number that changes every time the z-index of any component changes. */
+        static Uint32 getZIndexGeneration() { return zIndexGeneration; }
+
+        /**
+         * Insert a component into a list sorted by z-index, after all components with the same z-index.
+         * @param list A list sorted by z-index.
+         * @param component The component to insert.
+         */
+        static void insertByZIndex(std::vector<Component *> &list, Component *component);
+
+        /**
+         * Restore the z-index order of a list after z-indices have changed, keeping the order of components with the same z-index.
+         * This is linear for a list where only a few components have moved.
+         * @param list The list to sort.
+         */
+        static void sortByZIndex(std::vector<Component *> &list);
 
         void addChild(Component *child);
 
@@ -123,7 +173,10 @@ namespace fruitwork
 
         Component *getParent() const { return parent; }
 
-        std::vector<Component *> getChildren() const { return children; }
+        /**
+         * @return A view of the children of this component. Adding or removing children invalidates the view.
+         */
+        ComponentView getChildren() const { return ComponentView(children); }
 
         int width() const { return rect.w; }
 
@@ -166,7 +219,11 @@ namespace fruitwork
         /* Sets pivot values based on a preset */
         void setPivot(Anchor anchorPreset);
 
-        void setPivot(SDL_FPoint newPivot) { this->normalizedPivot = newPivot; }
+        void setPivot(SDL_FPoint newPivot)
+        {
+            this->normalizedPivot = newPivot;
+            invalidateTransform();
+        }
 
         SDL_Point getSizeDelta() const;
 
@@ -181,12 +238,41 @@ namespace fruitwork
     protected:
         Component(int x, int y, int w, int h);
 
+        /**
+         * Marks the absolute rect of this component and all its descendants as outdated.
+         * It will be recalculated the next time it is read.
+         */
+        void invalidateTransform();
+
     private:
+        friend class Scene;
+
+        friend class Session;
+
         SDL_Rect rect;
         mutable SDL_Rect absoluteRect;
 
+        /** The slot of this component in its scene's handle table, -1 if it is not in a scene. */
+        int sceneSlot = -1;
+
+        /**
+         * The scene or session whose list the component is in, nullptr once it has been removed from it.
+         * A removed component stays in the list until it is compacted at the end of the frame.
+         */
+        const void *container = nullptr;
+
+        /** Whether absoluteRect has to be recalculated. If a component is dirty, so are all of its descendants. */
+        mutable bool transformDirty = true;
+
+        /** The window layout generation absoluteRect was calculated in. */
+        mutable Uint32 transformGeneration = 0;
+
+        SDL_Rect calculateAbsoluteRect() const;
+
         int z = 0; // z-index
 
+        static Uint32 zIndexGeneration;
+
         std::vector<Component *> children = std::vector<Component *>();
         Component *parent = nullptr;
 
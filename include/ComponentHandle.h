@@ -0,0 +1,29 @@
+#ifndef FRUITWORK_COMPONENT_HANDLE_H
+#define FRUITWORK_COMPONENT_HANDLE_H
+
+#include <SDL.h>
+
+namespace fruitwork
+{
+    /**
+     * A stable reference to a component in a Scene. Unlike a Component pointer, a handle can be checked for validity:
+     * once the component is removed from its scene, resolving the handle returns nullptr instead of a dangling pointer.
+     * @see fruitwork::Scene::resolve
+     */
+    struct ComponentHandle {
+        /** The slot of the component in the scene's handle table. */
+        Uint32 index = 0;
+
+        /** Incremented every time the slot is reused. A generation of 0 is never used, so a default handle is always null. */
+        Uint32 generation = 0;
+
+        bool isNull() const { return generation == 0; }
+
+        bool operator==(const ComponentHandle &other) const { return index == other.index && generation == other.generation; }
+
+        bool operator!=(const ComponentHandle &other) const { return !(*this == other); }
+    };
+
+} // fruitwork
+
+#endif //FRUITWORK_COMPONENT_HANDLE_H
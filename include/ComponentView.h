@@ -0,0 +1,52 @@
+#ifndef FRUITWORK_COMPONENT_VIEW_H
+#define FRUITWORK_COMPONENT_VIEW_H
+
+#include <vector>
+#include <cstddef>
+
+namespace fruitwork
+{
+    class Component;
+
+    class Scene;
+
+    /**
+     * A non-owning, read-only view of a list of components. Creating or iterating a view never copies the list.
+     * While a view of a Scene is alive the scene will not reorder its list: components added in the meantime are
+     * inserted once the last view is destroyed, and removals are always deferred to the end of the frame.
+     */
+    class ComponentView {
+    public:
+        using iterator = Component *const *;
+
+        /**
+         * @param components The list to view. It must outlive the view.
+         * @param owner The scene owning the list, if any. The scene defers insertions while the view is alive.
+         */
+        explicit ComponentView(const std::vector<Component *> &components, Scene *owner = nullptr);
+
+        ComponentView(const ComponentView &other);
+
+        ComponentView &operator=(const ComponentView &) = delete;
+
+        ~ComponentView();
+
+        iterator begin() const { return first; }
+
+        iterator end() const { return last; }
+
+        std::size_t size() const { return last - first; }
+
+        bool empty() const { return first == last; }
+
+        Component *operator[](std::size_t index) const { return first[index]; }
+
+    private:
+        iterator first;
+        iterator last;
+        Scene *owner;
+    };
+
+} // fruitwork
+
+#endif //FRUITWORK_COMPONENT_VIEW_H
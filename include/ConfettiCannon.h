@@ -1,15 +1,14 @@
 #ifndef FRUITWORK_CONFETTI_CANNON_H
 #define FRUITWORK_CONFETTI_CANNON_H
 
-#include <SDL_rect.h>
-#include "Component.h"
-#include "Rectangle.h"
-#include "Sprite.h"
+#include <vector>
+#include "ParticleSystem.h"
 
 namespace fruitwork
 {
 
-    class ConfettiCannon : public Component {
+    /** A particle system firing bursts of colored confetti that fall down and fade out. */
+    class ConfettiCannon : public ParticleSystem {
     public:
         /**
          *
@@ -18,12 +17,6 @@ namespace fruitwork
          */
         static ConfettiCannon *getInstance(int x, int y, int w, int h, const std::string &texturePath);
 
-        ~ConfettiCannon() override;
-
-        void draw() const override;
-
-        void update(float elapsedTime) override;
-
         /***
          * Fires a confetti cannon.
          * @param angle The angle the confetti will be fired at.
@@ -39,8 +32,6 @@ namespace fruitwork
     private:
         explicit ConfettiCannon(int x, int y, int w, int h, const std::string &texturePath);
 
-        SDL_Texture *texture;
-
         // pastel colors
         std::vector<SDL_Color> colors = {
                 {255, 153, 153},
@@ -58,20 +49,23 @@ namespace fruitwork
                 {255, 153, 255}
         };
 
-        struct Confetti {
-            Sprite *sprite = nullptr;
-            SDL_FPoint force = {0, 0};
-            Uint64 startTime = 0;
-            bool started = false;
-            int fadeOutTime = -1;
+        /**
+         * An emitter per fade out time, the fade out of confetti in flight is read from its emitter.
+         * The direction is given per burst, so a cannon aimed somewhere else every shot still needs one emitter.
+         */
+        struct Fade {
+            int fadeOutTime;
+            int emitter;
 
-            ~Confetti()
-            {
-                delete sprite;
-            }
+            /** Counts up with every shot, the fade fired the longest ago is replaced when all are taken. */
+            Uint32 lastShot;
         };
 
-        std::vector<Confetti *> confetti;
+        std::vector<Fade> fades;
+        Uint32 shotCount = 0;
+
+        /** @return The emitter of a fade out time, set up for it if it wasn't already. */
+        int getFadeEmitter(int fadeOutTime);
     };
 
 
@@ -7,6 +7,12 @@ namespace constants
 {
     const std::string gResPath = "resources/";
     const int gFps = 60;
+
+    /** The rate (in Hz) the simulation is stepped at, independent of the frame rate. */
+    const int gSimulationRate = 60;
+
+    /** The maximum amount of simulation steps per frame before the simulation falls behind real time. */
+    const int gMaxSubsteps = 8;
     const int gScreenWidth = 1200;
     const int gScreenHeight = 900;
 
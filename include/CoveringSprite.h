@@ -15,17 +15,28 @@ namespace fruitwork
 
         static CoveringSprite *getInstance(int x, int y, int w, int h, SDL_Texture *texture);
 
+        static CoveringSprite *getInstance(int x, int y, int w, int h, const TextureAtlas::Region &region);
+
+        /** @see Sprite::getAtlasInstance */
+        static CoveringSprite *getAtlasInstance(int x, int y, int w, int h, const std::string &imageName);
+
         void start() override;
 
         void setTexture(const std::string &texturePath) override;
 
         void setTexture(SDL_Texture *texture) override;
 
+        using Sprite::setRegion;
+
+        void setRegion(const TextureAtlas::Region &region) override;
+
     protected:
         CoveringSprite(int x, int y, int w, int h, const std::string &texturePath);
 
         CoveringSprite(int x, int y, int w, int h, SDL_Texture *texture);
 
+        CoveringSprite(int x, int y, int w, int h, const TextureAtlas::Region &region);
+
     private:
         SDL_Rect originalRect;
 
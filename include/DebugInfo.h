@@ -19,6 +19,8 @@ namespace fruitwork
 
         void draw() const override;
 
+        bool isDrawBatched() const override { return true; }
+
     protected:
         DebugInfo(int x, int y, int w, int h, Scene *s);
 
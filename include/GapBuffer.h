@@ -0,0 +1,53 @@
+#ifndef FRUITWORK_GAP_BUFFER_H
+#define FRUITWORK_GAP_BUFFER_H
+
+#include <string>
+#include <vector>
+
+namespace fruitwork
+{
+
+    /**
+     * Text stored with a gap of free space at the last edit position.
+     * Typing and deleting next to the previous edit only moves the edges of the gap, no matter how long the text is.
+     * Moving the gap to an edit somewhere else copies the text in between once.
+     */
+    class GapBuffer {
+    public:
+        explicit GapBuffer(size_t capacity = 64);
+
+        /** @return The length of the text in bytes. */
+        size_t size() const { return buffer.size() - (gapEnd - gapStart); }
+
+        char operator[](size_t index) const { return index < gapStart ? buffer[index] : buffer[index + gapEnd - gapStart]; }
+
+        /** Insert text before a position. */
+        void insert(size_t position, const char *text, size_t length);
+
+        /** Erase length bytes starting at a position. */
+        void erase(size_t position, size_t length);
+
+        /** Remove all text, keeping the allocated space. */
+        void clear();
+
+        /** Copy part of the text into out, replacing its contents. Reusing out between calls avoids allocations. */
+        void copy(size_t position, size_t length, std::string &out) const;
+
+        /** @return The whole text. */
+        std::string toString() const;
+
+    private:
+        /** Move the gap so it starts at a position. */
+        void moveGap(size_t position);
+
+        /** Make the gap at least a certain length. */
+        void grow(size_t length);
+
+        std::vector<char> buffer;
+        size_t gapStart = 0;
+        size_t gapEnd;
+    };
+
+} // fruitwork
+
+#endif //FRUITWORK_GAP_BUFFER_H
@@ -0,0 +1,112 @@
+#ifndef FRUITWORK_GLYPH_ATLAS_H
+#define FRUITWORK_GLYPH_ATLAS_H
+
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace fruitwork
+{
+
+    /**
+     * The glyphs of a font, rasterized once in white into a few shared textures.
+     * Text is laid out as one quad per glyph and colored through the RenderQueue's vertex colors, so changing
+     * a text or its color neither renders a surface nor uploads a texture, unless a glyph is used for the first time.
+     */
+    class GlyphAtlas {
+    public:
+        /** A glyph placed by layout, relative to the top left of the text. */
+        struct PlacedGlyph {
+            SDL_Texture *page;
+            SDL_Rect source;
+            SDL_Rect destination;
+        };
+
+        /** A laid out text, reused between layouts so changing the text doesn't allocate. */
+        struct TextLayout {
+            std::vector<PlacedGlyph> glyphs;
+            int width = 0;
+            int height = 0;
+
+            /**
+             * Submit the glyphs to the RenderQueue.
+             * @param position The top left of the text.
+             * @param color The color of the text.
+             * @param scale The scale to draw the text at, 1 for the size of the font.
+             */
+            void draw(SDL_Point position, SDL_Color color, float scale = 1) const;
+        };
+
+        /** @return The atlas of a font, created on first use. */
+        static GlyphAtlas *getInstance(TTF_Font *font);
+
+        /** Destroy the atlas of a font. Must be called before the font is closed, another font could reuse its address. */
+        static void release(TTF_Font *font);
+
+        GlyphAtlas(const GlyphAtlas &) = delete;
+
+        GlyphAtlas &operator=(const GlyphAtlas &) = delete;
+
+        /**
+         * Lay out a UTF-8 text with kerning, breaking lines at newlines.
+         * @param text The text to lay out.
+         * @param layout The layout to fill, its previous glyphs are replaced.
+         * @param wrapWidth If positive, lines are also broken at the last space before they get wider than this.
+         */
+        void layout(const std::string &text, TextLayout &layout, int wrapWidth = 0);
+
+        /** @return The width of a single line of UTF-8 text, without laying it out. */
+        int measure(const std::string &text);
+
+        /**
+         * @param codepoint The codepoint to advance past.
+         * @param previous The codepoint before it, 0 for none. Kerning between the two is included.
+         * @return How far the pen moves for the codepoint.
+         */
+        int getAdvance(Uint32 codepoint, Uint32 previous = 0);
+
+        /** Decode the UTF-8 sequence at index and move index past it. Invalid sequences decode to U+FFFD. */
+        static Uint32 decodeUtf8(const std::string &text, size_t &index);
+
+    private:
+        explicit GlyphAtlas(TTF_Font *font);
+
+        ~GlyphAtlas();
+
+        struct Glyph {
+            SDL_Texture *page = nullptr;
+            SDL_Rect source = {0, 0, 0, 0};
+
+            /** Where the glyph's surface starts relative to the pen, negative for glyphs reaching back. */
+            int offsetX = 0;
+            int advance = 0;
+        };
+
+        /** @return The glyph of a codepoint, rasterized if it is used for the first time. */
+        const Glyph &getGlyph(Uint32 codepoint);
+
+        /** Find space for a glyph, starting a new page if the current one is full. */
+        SDL_Texture *allocate(int w, int h, SDL_Point &position);
+
+        /** The width and height of a page. */
+        static const int PAGE_SIZE = 512;
+
+        TTF_Font *font;
+        bool kerning;
+        int lineSkip;
+        int fontHeight;
+
+        std::unordered_map<Uint32, Glyph> glyphs;
+        std::vector<SDL_Texture *> pages;
+
+        // the shelf glyphs are currently added to, on the last page
+        int shelfX = 0;
+        int shelfY = 0;
+        int shelfHeight = 0;
+    };
+
+} // fruitwork
+
+#endif //FRUITWORK_GLYPH_ATLAS_H
@@ -14,6 +14,11 @@ namespace fruitwork
 
         static ImageButton *getInstance(int x, int y, int w, int h, const std::string &texturePath);
 
+        static ImageButton *getInstance(int x, int y, int w, int h, const TextureAtlas::Region &region);
+
+        /** @see Sprite::getAtlasInstance */
+        static ImageButton *getAtlasInstance(int x, int y, int w, int h, const std::string &imageName);
+
         void start() override;
 
         void draw() const override;
@@ -25,6 +30,8 @@ namespace fruitwork
 
         ImageButton(int x, int y, int w, int h, const std::string &texturePath);
 
+        ImageButton(int x, int y, int w, int h, const TextureAtlas::Region &region);
+
     private:
         SDL_Rect originalRect;
         ResponsiveSprite *sprite;
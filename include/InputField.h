@@ -2,8 +2,11 @@
 #define FRUITWORK_INPUT_FIELD_H
 
 #include <string>
+#include <vector>
 #include <SDL_ttf.h>
 #include "Component.h"
+#include "ResourceManager.h"
+#include "GlyphAtlas.h"
 #include "Constants.h"
 
 namespace fruitwork
@@ -24,7 +27,9 @@ namespace fruitwork
 
         void draw() const override;
 
-        ~InputField() override;
+        bool isDrawBatched() const override { return true; }
+
+        ~InputField() override = default;
 
         void update() override;
 
@@ -42,6 +47,12 @@ namespace fruitwork
 
         int getMaxLength() const { return maxLength; }
 
+        /**
+         * Stop or start accepting text input. Shared by all text input components, text input stays on while any of them is focused.
+         * @param listening true when a component gains focus, false when it loses it.
+         */
+        static void setListenerState(bool listening);
+
     protected:
         InputField(int x, int y, int w, int h, const std::string &placeholderText, InputType inputType);
 
@@ -65,19 +76,25 @@ namespace fruitwork
         /** If the input field is currently hovered it should be slightly gray. */
         bool isHovered = false;
 
-        SDL_Texture *textTexture = nullptr;
-        SDL_Texture *placeholderTexture = nullptr;
-        SDL_Texture *textureLeft, *textureMiddle, *textureRight;
+        GlyphAtlas::TextLayout textLayout;
+        GlyphAtlas::TextLayout placeholderLayout;
+
+        /** The text as it is shown, masked for passwords. */
+        std::string shownText;
+        ResourceManager::TextureHandle textureLeft, textureMiddle, textureRight;
 
         /** The amount of input fields currently listening for input. */
         static int listenerCount;
 
-        /** Stop or start accepting input. */
-        static void setListenerState(bool listening);
-
         /** Replaces all characters with an asterisk. */
         std::string getPasswordMask() const;
 
+        /**
+         * Lay out the shown text again after it changed.
+         * @param changedFrom The first byte that changed, caret offsets before it are kept.
+         */
+        void updateText(size_t changedFrom);
+
 #pragma endregion
 
 #pragma region Caret properties
@@ -90,9 +107,17 @@ namespace fruitwork
         const int CARET_BLINK_INTERVAL = (double) constants::gFps / 1.88; // NOLINT
         int caretBlinkCounter = 0;
         bool caretVisible = true;
-        SDL_Texture *caretTexture = nullptr;
         int caretPosition = 0;
 
+        /**
+         * The x offset of the caret for every byte position in the shown text, a running sum of glyph advances.
+         * Positions inside a multibyte character have the offset of the character.
+         */
+        std::vector<int> caretOffsets = {0};
+
+        /** @return The caret position closest to an x coordinate relative to the start of the text. */
+        int getCaretPositionAt(int x) const;
+
 #pragma endregion
     };
 
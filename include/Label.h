@@ -7,6 +7,8 @@
 #include <Constants.h>
 #include <SDL_ttf.h>
 #include "System.h"
+#include "GlyphAtlas.h"
+#include "ResourceManager.h"
 
 namespace fruitwork
 {
@@ -38,44 +40,71 @@ namespace fruitwork
 
         void setAlignment(Alignment a);
 
-        void setAllowWrap(bool wrap) { allowWrap = wrap; }
+        void setAllowWrap(bool wrap)
+        {
+            if (allowWrap != wrap)
+                layoutDirty = true;
 
-        bool getAllowWrap() const { return allowWrap; }
+            allowWrap = wrap;
+        }
 
-        void update() override;
+        bool getAllowWrap() const { return allowWrap; }
 
         void draw() const override;
 
-        ~Label() override;
+        bool isDrawBatched() const override { return true; }
+
+        ~Label() override = default;
 
     protected:
         Label(int x, int y, int w, int h, const std::string &text);
 
     private:
         std::string text;
-        SDL_Texture *texture = nullptr;
         SDL_Color color = {0, 0, 0, 255};
 
         int fontSize = 24;
         std::string fontPath = constants::gDefaultFontPath;
-        TTF_Font *font = nullptr;
 
         /**
-         * Whether or not this component owns the font and should free it on destruction.
+         * Whether the font is the one at fontPath and fontSize, instead of one set with setFont.
          */
         bool isFontOwner = true;
 
         Alignment alignment = Alignment::LEFT;
 
+        bool allowWrap = false;
+
+        /**
+         * Setters only mark the label dirty, it is laid out once right before it is drawn.
+         * Everything below is updated lazily by updateLayout.
+         */
+        mutable bool layoutDirty = true;
+
+        /** The font at fontPath and fontSize has to be fetched from the font cache. */
+        mutable bool fontDirty = true;
+
+        mutable TTF_Font *font = nullptr;
+
+        /** Keeps the font at fontPath and fontSize open, shared with every label using the same font. */
+        mutable ResourceManager::FontHandle fontHandle;
+
+        /** The glyphs of the text, drawn from the font's glyph atlas. */
+        mutable GlyphAtlas::TextLayout textLayout;
+
+        /** The text is scaled down if it is wider than the rect. */
+        mutable float textScale = 1;
+
         /**
          * The rect that the text is drawn to.
          */
-        SDL_Rect drawRect;
+        mutable SDL_Rect drawRect = {0, 0, 0, 0};
 
-        /** The rect that the last texture was rendered to. */
-        SDL_Rect lastAbsoluteDrawnRect;
+        /** The absolute rect of the label when it was last laid out or moved. */
+        mutable SDL_Rect lastAbsoluteDrawnRect = {0, 0, 0, 0};
 
-        bool allowWrap = false;
+        /** Lay out the text if anything changed, or move the layout if only the position of the label did. */
+        void updateLayout() const;
     };
 
 } // fruitwork
@@ -0,0 +1,228 @@
+#ifndef FRUITWORK_PARTICLE_SYSTEM_H
+#define FRUITWORK_PARTICLE_SYSTEM_H
+
+#include <string>
+#include <vector>
+#include <random>
+#include <SDL.h>
+#include "Component.h"
+#include "ResourceManager.h"
+
+namespace fruitwork
+{
+
+    /**
+     * Simulates and draws many small textured quads emitted by emitters.
+     * Particles are plain numbers in one array per property, so every simulation step is a few tight loops over them,
+     * and a dead particle is replaced by the last one. All particles of a system are drawn in a single batch.
+     */
+    class ParticleSystem : public Component {
+    public:
+        /** A value that changes linearly over the lifetime of a particle. */
+        struct Curve {
+            /** The value before from. */
+            float start = 1;
+
+            /** The value after to. */
+            float end = 1;
+
+            /** When the value starts changing, as a fraction of the lifetime. */
+            float from = 0;
+
+            /** When the value stops changing, as a fraction of the lifetime. */
+            float to = 1;
+
+            /** @param t The age of the particle as a fraction of its lifetime. */
+            float evaluate(float t) const
+            {
+                if (t <= from)
+                    return start;
+
+                if (t >= to)
+                    return end;
+
+                return start + (end - start) * (t - from) / (to - from);
+            }
+        };
+
+        /** How particles are emitted. Angles are in degrees, times in seconds and distances in pixels. */
+        struct Emitter {
+            /** Where particles are emitted, relative to the top left of the particle system. */
+            SDL_FPoint position = {0, 0};
+
+            /** The size of a particle at a scale of 1. */
+            SDL_Point size = {16, 16};
+
+            /** Particles emitted every second, continuously. 0 to only emit bursts. */
+            float rate = 0;
+
+            /** The direction particles are launched in, 0 is to the right and 90 is down. */
+            float angle = 0;
+
+            /** The range of directions around angle. An angle of 45 and a spread of 10 launches particles at 40 to 50. */
+            float spread = 360;
+
+            float minSpeed = 100;
+            float maxSpeed = 100;
+
+            /** Scales the launch velocity per axis, e.g. to launch particles further up than sideways. */
+            SDL_FPoint speedScale = {1, 1};
+
+            float minLifetime = 1;
+            float maxLifetime = 1;
+
+            /** The rotation particles start with. */
+            float minRotation = 0;
+            float maxRotation = 0;
+
+            /** How fast particles rotate, clockwise in degrees per second. */
+            float minAngularVelocity = 0;
+            float maxAngularVelocity = 0;
+
+            /** The opacity over the lifetime, 0 to 1. */
+            Curve alpha;
+
+            /** The scale of the size over the lifetime. */
+            Curve scale;
+
+            /** Every particle gets one of these colors, picked at random. */
+            std::vector<SDL_Color> colors = {{255, 255, 255, 255}};
+        };
+
+        /**
+         * @param w The width of the particle system, particles are not limited to it.
+         * @param h The height of the particle system, particles are not limited to it.
+         * @param texturePath The texture of every particle.
+         */
+        static ParticleSystem *getInstance(int x, int y, int w, int h, const std::string &texturePath);
+
+        void draw() const override;
+
+        bool isDrawBatched() const override { return true; }
+
+        void update(float elapsedTime) override;
+
+        void interpolate(float alpha) override;
+
+        /**
+         * Add an emitter. It starts emitting right away if it has a rate.
+         * @return The index of the emitter.
+         */
+        int addEmitter(const Emitter &emitter);
+
+        /**
+         * @return An emitter to change. Changing its curves also changes them for the particles it already emitted.
+         */
+        Emitter &getEmitter(int index) { return emitters[index].emitter; }
+
+        int getEmitterCount() const { return (int) emitters.size(); }
+
+        /**
+         * Emit a number of particles on top of the rate of an emitter.
+         * @param emitter The index of the emitter.
+         * @param count The amount of particles.
+         * @param duration The time to spread the particles over, 0 to emit them all at once.
+         */
+        void burst(int emitter, int count, float duration = 0);
+
+        /**
+         * Emit a number of particles in another direction than the emitter's, e.g. from a cannon that is aimed somewhere else every shot.
+         * The emitter isn't changed, so bursts in different directions can be emitted at the same time.
+         * @param angle The direction of this burst, in degrees.
+         * @param spread The range of directions around angle, in degrees.
+         */
+        void burst(int emitter, int count, float duration, float angle, float spread);
+
+        /** @return The amount of particles alive that were emitted by an emitter. */
+        int getParticleCount(int emitter) const;
+
+        /** @param g The acceleration pulling particles down, in pixels per second squared. */
+        void setGravity(float g) { this->gravity = g; }
+
+        float getGravity() const { return gravity; }
+
+        /** @param d The fraction of their velocity particles lose every second. */
+        void setDrag(float d) { this->drag = d; }
+
+        float getDrag() const { return drag; }
+
+        /** @param max The most particles alive at once, particles emitted past it are dropped. */
+        void setMaxParticles(int max) { this->maxParticles = max; }
+
+        int getMaxParticles() const { return maxParticles; }
+
+        /** @return The amount of particles alive. */
+        int getParticleCount() const { return (int) particles.x.size(); }
+
+        /** Remove all particles and pending bursts. */
+        void clear();
+
+    protected:
+        ParticleSystem(int x, int y, int w, int h, const std::string &texturePath);
+
+    private:
+        ResourceManager::TextureHandle texture;
+
+        struct EmitterState {
+            Emitter emitter;
+
+            /** Fractions of a particle carried over to the next step, so low rates still emit. */
+            float rateAccumulator = 0;
+        };
+
+        std::vector<EmitterState> emitters;
+
+        /** A burst spread over time, its particles still to be emitted at rate per second. */
+        struct Burst {
+            int emitter;
+            int remaining;
+            float rate;
+            float accumulator;
+            float angle;
+            float spread;
+        };
+
+        std::vector<Burst> bursts;
+
+        /** The particles, one array per property. Index i of every array is the same particle. */
+        struct Particles {
+            /** The center of the particle. */
+            std::vector<float> x, y;
+
+            /** The center before the last step, to draw between steps. */
+            std::vector<float> previousX, previousY;
+            std::vector<float> velocityX, velocityY;
+
+            /** The rotation and rotation speed, in radians. */
+            std::vector<float> rotation, angularVelocity;
+
+            /** The age and lifetime, in seconds. */
+            std::vector<float> age, lifetime;
+            std::vector<SDL_Color> color;
+            std::vector<int> emitter;
+        };
+
+        Particles particles;
+
+        float gravity = 0;
+        float drag = 0;
+        int maxParticles = 100000;
+
+        /** How far between the last two steps to draw. */
+        float interpolationAlpha = 1;
+
+        std::mt19937 random;
+
+        /** Emit particles from an emitter, launched in a range of spread degrees around angle. */
+        void emit(int emitter, int count, float angle, float spread);
+
+        /** Replace the particle at an index with the last one. */
+        void remove(size_t index);
+
+        /** @return A random number between min and max. */
+        float randomRange(float min, float max);
+    };
+
+} // fruitwork
+
+#endif //FRUITWORK_PARTICLE_SYSTEM_H
@@ -31,13 +31,15 @@ namespace fruitwork
 
         void setVelocity(SDL_FPoint v) { this->velocity = v; }
 
+        /** Teleports the body. The position is not interpolated from the previous step. */
         void setPosition(float x, float y)
         {
             position.x = x;
             position.y = y;
+            previousPosition = position;
         }
 
-        void setPosition(SDL_FPoint p) { this->position = p; }
+        void setPosition(SDL_FPoint p) { setPosition(p.x, p.y); }
 
         SDL_FPoint getVelocity() const { return velocity; }
 
@@ -70,6 +72,12 @@ namespace fruitwork
         // get the bounding box of the physics body
         const SDL_Rect &getRect() const { return rect; }
 
+        /**
+         * @param alpha How far between the previous and the current simulation step to blend, 0 is the previous step and 1 the current.
+         * @return The bounding box of the physics body, interpolated between the last two simulation steps.
+         */
+        SDL_Rect getInterpolatedRect(float alpha) const;
+
 #pragma endregion
 
         // check if the physics body is colliding with another body
@@ -89,6 +97,7 @@ namespace fruitwork
         SDL_Rect rect;
         SDL_FPoint velocity = {0.0f, 0.0f};
         SDL_FPoint position = {0.0f, 0.0f}; // to avoid rounding errors
+        SDL_FPoint previousPosition = {0.0f, 0.0f}; // position before the last step, used for interpolation
         SDL_FPoint acceleration = {0.0f, 0.0f};
         float mass = 1.0f;
         float elasticity = 0.5f;
@@ -0,0 +1,156 @@
+#ifndef FRUITWORK_PHYSICS_WORLD_H
+#define FRUITWORK_PHYSICS_WORLD_H
+
+#include <SDL.h>
+#include <vector>
+#include <functional>
+#include <unordered_map>
+#include "PhysicsBody.h"
+#include "ComponentView.h"
+
+namespace fruitwork
+{
+    class Component;
+
+    /**
+     * Keeps every physics body of a scene in a dynamic AABB tree, to answer spatial queries
+     * ("what is under this point", "what overlaps this rect", "what does this ray hit") in logarithmic time.
+     * Every body is stored with a slightly enlarged (fat) box, so bodies that move a little don't have to be re-inserted.
+     * @see <a href="https://box2d.org/files/ErinCatto_DynamicBVH_GDC2019.pdf">Dynamic Bounding Volume Hierarchies</a>
+     */
+    class PhysicsWorld {
+    public:
+        struct Hit {
+            Component *component;
+            PhysicsBody *body;
+
+            /**
+             * For point and rect queries, the distance from the query's center to the center of the body.
+             * For raycasts, the distance along the ray to where it enters the body.
+             */
+            float distance;
+        };
+
+        /** Called for every hit, nearest first. Return false to stop the query. */
+        using HitCallback = std::function<bool(const Hit &)>;
+
+        PhysicsWorld() = default;
+
+        PhysicsWorld(const PhysicsWorld &) = delete;
+
+        PhysicsWorld &operator=(const PhysicsWorld &) = delete;
+
+        /**
+         * Bring the tree up to date with the physics bodies of the given components.
+         * New bodies are inserted, moved bodies are refit and bodies that are no longer present are removed.
+         * @param components The components whose bodies should be in the world.
+         */
+        void sync(const ComponentView &components);
+
+        /**
+         * Remove a body from the world. The body is never dereferenced, so this is safe to call right before deleting it.
+         * @param body The body to remove.
+         */
+        void removeBody(const PhysicsBody *body);
+
+        /** Remove all bodies from the world. */
+        void clear();
+
+        /** Find all bodies whose rect contains the point, nearest first. */
+        void queryPoint(SDL_FPoint point, const HitCallback &callback) const;
+
+        std::vector<Hit> queryPoint(SDL_FPoint point) const;
+
+        /** Find all bodies whose rect overlaps the given rect, nearest first. */
+        void queryRect(const SDL_Rect &rect, const HitCallback &callback) const;
+
+        std::vector<Hit> queryRect(const SDL_Rect &rect) const;
+
+        /**
+         * Find all bodies hit by a ray, nearest first.
+         * @param origin The start of the ray.
+         * @param direction The direction of the ray. Does not have to be normalized.
+         * @param maxDistance How far the ray reaches, in pixels.
+         */
+        void raycast(SDL_FPoint origin, SDL_FPoint direction, float maxDistance, const HitCallback &callback) const;
+
+        std::vector<Hit> raycast(SDL_FPoint origin, SDL_FPoint direction, float maxDistance) const;
+
+        /** @return The amount of bodies in the world. */
+        int size() const { return (int) proxies.size(); }
+
+    private:
+        struct AABB {
+            float minX, minY, maxX, maxY;
+        };
+
+        struct Node {
+            /** The fat box for leaves, the union of both children otherwise. */
+            AABB box;
+
+            /** The exact box of the body as of the last sync. */
+            AABB bodyBox;
+
+            int parent = -1;
+            int left = -1;
+            int right = -1;
+
+            /** Leaves have height 0, free nodes -1. */
+            int height = -1;
+
+            Component *component = nullptr;
+            PhysicsBody *body = nullptr;
+            Uint32 lastSeen = 0;
+        };
+
+        /** How far the box of a body is enlarged on every side, in pixels. */
+        static constexpr float FAT_MARGIN = 16.0f;
+
+        std::vector<Node> nodes;
+        int root = -1;
+        int freeList = -1;
+        Uint32 syncStamp = 0;
+
+        /** Leaf index per body. */
+        std::unordered_map<const PhysicsBody *, int> proxies;
+
+        int allocateNode();
+
+        void freeNode(int index);
+
+        void insertLeaf(int leaf);
+
+        void removeLeaf(int leaf);
+
+        /** Rotates the subtree at index if it is unbalanced. @return The new root of the subtree. */
+        int balance(int index);
+
+        /** Walks from index to the root, rebalancing and refitting every ancestor. */
+        void refitAncestors(int index);
+
+        bool isLeaf(int index) const { return nodes[index].left == -1; }
+
+        /**
+         * Visits leaves in order of increasing distance. Internal nodes are ordered by a lower bound of the distance of
+         * anything they contain, which makes the first leaf visited the nearest one.
+         * @param nodeDistance Distance lower bound for a box, negative if the box can't contain a hit.
+         * @param leafDistance Exact distance for a body's rect, negative if it is not a hit.
+         */
+        void bestFirst(const std::function<float(const AABB &)> &nodeDistance,
+                       const std::function<float(const AABB &)> &leafDistance,
+                       const HitCallback &callback) const;
+
+        static AABB toAABB(const SDL_Rect &rect);
+
+        static AABB fatten(const AABB &box);
+
+        static AABB combine(const AABB &a, const AABB &b);
+
+        static bool contains(const AABB &outer, const AABB &inner);
+
+        static float perimeter(const AABB &box);
+    };
+
+} // fruitwork
+
+#endif //FRUITWORK_PHYSICS_WORLD_H
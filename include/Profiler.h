@@ -0,0 +1,155 @@
+#ifndef FRUITWORK_PROFILER_H
+#define FRUITWORK_PROFILER_H
+
+#include <SDL.h>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <typeinfo>
+
+namespace fruitwork
+{
+    /**
+     * Records timed zones and counters, and writes them as a Chrome trace (chrome://tracing, https://ui.perfetto.dev).
+     * Every thread records into its own buffer and gets its own track in the trace.
+     * Use the FRUITWORK_PROFILE_* macros instead of calling this directly: they compile to nothing unless
+     * FRUITWORK_PROFILING is defined, and cost a single branch while the profiler is not recording.
+     * @see <a href="https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU">Trace Event Format</a>
+     */
+    class Profiler {
+    public:
+        static Profiler *getInstance() { return &instance; }
+
+        Profiler(const Profiler &) = delete;
+
+        Profiler &operator=(const Profiler &) = delete;
+
+        /** Start recording. Previously recorded events are discarded. Start, stop and writeTrace are meant for the main thread. */
+        void start();
+
+        /** Stop recording. The recorded events are kept until the next start. */
+        void stop();
+
+        /** @return true if the profiler is recording. */
+        static bool isRecording() { return recording.load(std::memory_order_relaxed); }
+
+        /**
+         * Record a zone. Prefer FRUITWORK_PROFILE_ZONE, which records the zone for the rest of the scope.
+         * @param name The name of the zone. It must outlive the profiler, e.g. a string literal or a type name.
+         * @param start The performance counter value the zone started at.
+         * @param end The performance counter value the zone ended at.
+         * @param isTypeName If true, name is a mangled name from std::type_info, demangled when the trace is written.
+         */
+        void zone(const char *name, Uint64 start, Uint64 end, bool isTypeName = false);
+
+        /**
+         * Record the value of a counter, drawn as a graph in the trace.
+         * @param name The name of the counter. It must outlive the profiler, e.g. a string literal.
+         */
+        void counter(const char *name, double value);
+
+        /** Name the calling thread's track in the trace. */
+        void setThreadName(const std::string &name);
+
+        /**
+         * Write everything recorded so far as Chrome trace JSON. Threads must not be recording while this is called.
+         * @return true if the trace was written.
+         */
+        bool writeTrace(const std::string &path) const;
+
+    private:
+        Profiler() = default;
+
+        ~Profiler();
+
+        static Profiler instance;
+
+        static std::atomic<bool> recording;
+
+        enum class EventType : Uint8 {
+            ZONE,
+            TYPE_ZONE,
+            COUNTER
+        };
+
+        struct Event {
+            const char *name;
+            EventType type;
+            Uint64 start;
+
+            /** The duration of a zone in counter ticks, unused for counters. */
+            Uint64 duration;
+
+            /** The value of a counter, unused for zones. */
+            double value;
+        };
+
+        struct ThreadBuffer {
+            SDL_threadID threadId;
+            std::string threadName;
+            std::vector<Event> events;
+
+            /** The amount of events that did not fit in the buffer. */
+            Uint64 dropped = 0;
+        };
+
+        /** A thread stops recording once its buffer has this many events, so a long capture can't exhaust memory. */
+        static const size_t MAX_EVENTS_PER_THREAD = 1 << 22;
+
+        /** Buffers of all threads that have recorded anything, guarded by buffersMutex. They live as long as the profiler. */
+        std::vector<ThreadBuffer *> buffers;
+        mutable std::mutex buffersMutex;
+
+        Uint64 captureStart = 0;
+
+        /** @return The calling thread's buffer, created on first use. */
+        ThreadBuffer *getThreadBuffer();
+
+        void record(const Event &event);
+    };
+
+    /** Records a zone from its construction to the end of its scope. */
+    class ProfileZone {
+    public:
+        explicit ProfileZone(const char *name, bool isTypeName = false)
+                : name(name), isTypeName(isTypeName), start(Profiler::isRecording() ? SDL_GetPerformanceCounter() : 0) {}
+
+        ~ProfileZone()
+        {
+            if (start != 0 && Profiler::isRecording())
+                Profiler::getInstance()->zone(name, start, SDL_GetPerformanceCounter(), isTypeName);
+        }
+
+        ProfileZone(const ProfileZone &) = delete;
+
+        ProfileZone &operator=(const ProfileZone &) = delete;
+
+    private:
+        const char *name;
+        bool isTypeName;
+        Uint64 start;
+    };
+
+} // fruitwork
+
+#define FRUITWORK_PROFILE_CONCAT_INNER(a, b) a##b
+#define FRUITWORK_PROFILE_CONCAT(a, b) FRUITWORK_PROFILE_CONCAT_INNER(a, b)
+
+#ifdef FRUITWORK_PROFILING
+/** Records a zone for the rest of the current scope. */
+#define FRUITWORK_PROFILE_ZONE(name) fruitwork::ProfileZone FRUITWORK_PROFILE_CONCAT(profileZone, __COUNTER__)(name)
+
+/** Records a zone named after the dynamic type of an object for the rest of the current scope. */
+#define FRUITWORK_PROFILE_TYPE_ZONE(object) fruitwork::ProfileZone FRUITWORK_PROFILE_CONCAT(profileZone, __COUNTER__)(typeid(object).name(), true)
+
+/** Records the value of a counter. */
+#define FRUITWORK_PROFILE_COUNTER(name, value) \
+    do { if (fruitwork::Profiler::isRecording()) fruitwork::Profiler::getInstance()->counter(name, value); } while (0)
+#else
+#define FRUITWORK_PROFILE_ZONE(name) do {} while (0)
+#define FRUITWORK_PROFILE_TYPE_ZONE(object) do {} while (0)
+#define FRUITWORK_PROFILE_COUNTER(name, value) do {} while (0)
+#endif
+
+#endif //FRUITWORK_PROFILER_H
@@ -10,17 +10,18 @@ namespace fruitwork
     public:
         static Rectangle *getInstance(int x, int y, int w, int h, SDL_Color c);
 
-        void draw() const override;
+        /** Round the corners with a radius, 0 for square corners. It is limited to half the width or height. */
+        void setCornerRadius(int r);
+
+        int getCornerRadius() const { return cornerRadius; }
 
     protected:
         Rectangle(int x, int y, int w, int h, SDL_Color c);
 
-    private:
-        /** Draw the rectangle with rotation. This is slightly more expensive than drawNormal, but with rotation support. */
-        void drawRotated() const;
+        void buildOutline(int w, int h, std::vector<SDL_FPoint> &outline) const override;
 
-        /** Draw the rectangle without rotation. This method of doing it is cheaper, but rotation is not supported. */
-        void drawNormal() const;
+    private:
+        int cornerRadius = 0;
     };
 
 } // fruitwork
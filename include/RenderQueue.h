@@ -0,0 +1,86 @@
+#ifndef FRUITWORK_RENDER_QUEUE_H
+#define FRUITWORK_RENDER_QUEUE_H
+
+#include <SDL.h>
+#include <vector>
+
+namespace fruitwork
+{
+
+    /**
+     * Collects the textured quads drawn during a frame and submits runs of quads with the same texture
+     * as a single SDL_RenderGeometry call, instead of one color mod, alpha mod and copy per quad.
+     * Quads are drawn in the order they are submitted, which is the z-order of the scene, so batching never changes
+     * what ends up on top. Sprites sharing a texture or an atlas page (see TextureAtlas) end up in the same run.
+     * Anything drawing with the renderer directly must call flush() first, so it is drawn over the queued quads.
+     */
+    class RenderQueue {
+    public:
+        static RenderQueue *getInstance() { return &instance; }
+
+        RenderQueue(const RenderQueue &) = delete;
+
+        RenderQueue &operator=(const RenderQueue &) = delete;
+
+        /**
+         * Queue a textured quad, with the same arguments as SDL_RenderCopyEx.
+         * @param texture The texture to draw, or nullptr for a quad filled with the color.
+         * @param source The part of the texture to draw, nullptr for the whole texture.
+         * @param destination Where to draw the quad.
+         * @param angle The clockwise rotation in degrees, around the center.
+         * @param center The point to rotate around, relative to the destination. nullptr for the center of the destination.
+         * @param flip How to flip the texture.
+         * @param color The color and alpha modulation, applied as vertex color.
+         */
+        void submit(SDL_Texture *texture, const SDL_Rect *source, const SDL_Rect &destination, double angle = 0,
+                    const SDL_Point *center = nullptr, SDL_RendererFlip flip = SDL_FLIP_NONE, SDL_Color color = {255, 255, 255, 255});
+
+        /**
+         * Make room for a mesh in the batch of a texture, for components that build their own geometry.
+         * @param texture The texture of the mesh, or nullptr for a mesh filled with its vertex colors.
+         * @param vertexCount The amount of vertices.
+         * @param meshIndices The triangles of the mesh, as indices into its own vertices. Queued right away.
+         * @param indexCount The amount of indices.
+         * @return The first of vertexCount vertices to fill in, valid until the next call to the queue.
+         */
+        SDL_Vertex *reserve(SDL_Texture *texture, int vertexCount, const int *meshIndices, int indexCount);
+
+        /**
+         * Make room for quads in the batch of a texture, for components that fill in many quads at once.
+         * The indices are queued already. The vertices of a quad are its top left, top right, bottom right and bottom left.
+         * @param texture The texture of the quads, or nullptr for quads filled with their vertex colors.
+         * @param quadCount The amount of quads.
+         * @return The first of quadCount * 4 vertices to fill in, valid until the next call to the queue.
+         */
+        SDL_Vertex *reserveQuads(SDL_Texture *texture, int quadCount);
+
+        /** Draw all queued quads. */
+        void flush();
+
+        /** Reset the draw call count. Called by the session at the start of every frame. */
+        void beginFrame() { drawCalls = 0; }
+
+        /** @return The amount of SDL_RenderGeometry calls since the start of the frame. */
+        int getDrawCallCount() const { return drawCalls; }
+
+    private:
+        RenderQueue() = default;
+
+        static RenderQueue instance;
+
+        /** Flush the queued quads if they have another texture, so quads of the texture can be queued. */
+        void useTexture(SDL_Texture *texture);
+
+        /** The texture of the queued quads, all queued quads share it. */
+        SDL_Texture *batchTexture = nullptr;
+        SDL_Point batchTextureSize = {1, 1};
+
+        std::vector<SDL_Vertex> vertices;
+        std::vector<int> indices;
+
+        int drawCalls = 0;
+    };
+
+} // fruitwork
+
+#endif //FRUITWORK_RENDER_QUEUE_H
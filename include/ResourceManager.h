@@ -2,17 +2,131 @@
 #define FRUITWORK_RESOURCE_MANAGER_H
 
 #include <string>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include <SDL_mixer.h>
 
 namespace fruitwork
 {
 
     class ResourceManager {
     public:
+        /** A texture shared by everyone who loaded the same file. It is destroyed when the last handle is released. */
+        using TextureHandle = std::shared_ptr<SDL_Texture>;
+
+        /** A surface shared by everyone who loaded the same file. It must not be modified. */
+        using SurfaceHandle = std::shared_ptr<SDL_Surface>;
+
+        /** A font shared by everyone who opened the same file at the same size and style. */
+        using FontHandle = std::shared_ptr<TTF_Font>;
+
+        /** A sound shared by everyone who loaded the same file. */
+        using SoundHandle = std::shared_ptr<Mix_Chunk>;
+
         static std::string getTexturePath(const std::string& textureName);
 
         static std::string getFontPath(const std::string& fontName);
 
         static std::string getAudioPath(const std::string& clipName);
+
+        /** @return If a file exists, in the asset archive or on disk. */
+        static bool exists(const std::string &path);
+
+        /**
+         * Open a file for reading, from the asset archive if it is in it, without copying it, or from disk otherwise.
+         * @param path The path of the file, e.g. from getTexturePath.
+         * @return A stream to pass to an SDL *_RW function that closes it, nullptr if the file could not be opened.
+         */
+        static SDL_RWops *openFile(const std::string &path);
+
+        /**
+         * Get a texture, loading it only if no one else holds it already.
+         * @param path The path of the image, e.g. from getTexturePath.
+         * @return A handle to the texture, empty if the image could not be loaded.
+         */
+        static TextureHandle getTexture(const std::string &path);
+
+        /** @return A texture if it is loaded already, empty otherwise. Never loads anything. */
+        static TextureHandle findTexture(const std::string &path);
+
+        /**
+         * Create the texture of an image from pixels decoded elsewhere, e.g. by the AssetLoader, unless it is loaded already.
+         * @param path The path of the image, the texture is cached under it.
+         * @param surface The decoded pixels, still owned by the caller.
+         * @return A handle to the texture, empty if it could not be created.
+         */
+        static TextureHandle addTexture(const std::string &path, SDL_Surface *surface);
+
+        /**
+         * Get the pixels of an image, loading them only if no one else holds them already.
+         * A texture of the same image loaded while the surface is held is created from it instead of decoding the image again.
+         * @param path The path of the image, e.g. from getTexturePath.
+         * @return A handle to the surface, empty if the image could not be loaded.
+         */
+        static SurfaceHandle getSurface(const std::string &path);
+
+        /**
+         * Forget the textures and surfaces no one holds anymore. They are freed with their last handle already, this drops their entries.
+         * Called on every scene change and when the system is low on memory.
+         */
+        static void releaseUnusedTextures();
+
+        /** @return The amount of textures currently loaded through the cache. */
+        static int getLoadedTextureCount();
+
+        /**
+         * Get a font, opening it only if it isn't open already.
+         * Fonts are kept open until the next scene change even when no one holds them anymore,
+         * so components created and destroyed during a scene don't reopen them.
+         * @param path The path of the font, e.g. from getFontPath.
+         * @param size The point size.
+         * @param style A TTF_STYLE_* combination.
+         * @return A handle to the font, empty if the font could not be opened.
+         */
+        static FontHandle getFont(const std::string &path, int size, int style = TTF_STYLE_NORMAL);
+
+        /**
+         * Stop keeping fonts open that no one holds anymore. Called on every scene change and when the system is low on memory.
+         * Fonts still held stay open.
+         */
+        static void releaseUnusedFonts();
+
+        /** @return The amount of fonts currently open through the cache. */
+        static int getOpenFontCount();
+
+        /**
+         * Get a sound, loading it only if it isn't loaded already.
+         * Sounds are small and played by many components, e.g. every button, so they stay loaded until releaseUnusedSounds
+         * even when no one holds them anymore, and scenes full of buttons never decode the same file twice.
+         * @param path The path of the sound, e.g. from getAudioPath.
+         * @return A handle to the sound, empty if the sound could not be loaded.
+         */
+        static SoundHandle getSound(const std::string &path);
+
+        /** @return A sound if it is loaded already, empty otherwise. Never loads anything. */
+        static SoundHandle findSound(const std::string &path);
+
+        /**
+         * Cache a sound decoded elsewhere, e.g. by the AssetLoader, unless it is loaded already.
+         * @param path The path of the sound, it is cached under it.
+         * @param sound The decoded sound.
+         * @return The cached sound, which is the one loaded before if there was one.
+         */
+        static SoundHandle addSound(const std::string &path, const SoundHandle &sound);
+
+        /** Unload sounds that no one holds anymore. Called when the system is low on memory and on shutdown. */
+        static void releaseUnusedSounds();
+
+        /** @return The amount of sounds currently loaded through the cache. */
+        static int getLoadedSoundCount();
+
+    private:
+        /** Loaded textures and surfaces by path. Entries expire when the last handle is released. */
+        static std::unordered_map<std::string, std::weak_ptr<SDL_Texture>> textures;
+        static std::unordered_map<std::string, std::weak_ptr<SDL_Surface>> surfaces;
     };
 
 } // fruitwork
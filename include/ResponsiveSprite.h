@@ -27,17 +27,28 @@ namespace fruitwork
 
         static ResponsiveSprite *getInstance(int x, int y, int w, int h, SDL_Texture *texture, Alignment alignment = Alignment::CENTER);
 
+        static ResponsiveSprite *getInstance(int x, int y, int w, int h, const TextureAtlas::Region &region, Alignment alignment = Alignment::CENTER);
+
+        /** @see Sprite::getAtlasInstance */
+        static ResponsiveSprite *getAtlasInstance(int x, int y, int w, int h, const std::string &imageName, Alignment alignment = Alignment::CENTER);
+
         void start() override;
 
         void setTexture(const std::string &texturePath) override;
 
         void setTexture(SDL_Texture *texture) override;
 
+        using Sprite::setRegion;
+
+        void setRegion(const TextureAtlas::Region &region) override;
+
     protected:
         ResponsiveSprite(int x, int y, int w, int h, const std::string &texturePath, Alignment alignment = Alignment::CENTER);
 
         ResponsiveSprite(int x, int y, int w, int h, SDL_Texture *texture, Alignment alignment = Alignment::CENTER);
 
+        ResponsiveSprite(int x, int y, int w, int h, const TextureAtlas::Region &region, Alignment alignment = Alignment::CENTER);
+
     private:
         Alignment alignment;
         SDL_Rect originalRect;
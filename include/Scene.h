@@ -3,7 +3,12 @@
 
 #include <SDL.h>
 #include <vector>
+#include <unordered_set>
 #include "Component.h"
+#include "ComponentView.h"
+#include "ComponentHandle.h"
+#include "Broadphase.h"
+#include "PhysicsWorld.h"
 
 namespace fruitwork
 {
@@ -17,31 +22,73 @@ namespace fruitwork
 
         /**
          * Add a component to the scene. Added components will automatically be started, drawn and updated.
+         * If the scene is being iterated, the component is added once the iteration is done.
          * @param component The component to add.
+         * @return A handle to the component, valid until the component is removed.
          */
-        void addComponent(Component *component);
+        ComponentHandle addComponent(Component *component);
+
+        /**
+         * Add several components to the scene at once. This sorts the scene once instead of once per component.
+         * @param newComponents The components to add, in the order they should be added.
+         */
+        void addComponents(const std::vector<Component *> &newComponents);
 
         /**
          * Adds a component to the scene at a specific index. Added components will automatically be started, drawn and updated.
          * @param component The component to add.
          * @param zIndex The z-index of the component. The z-index determines the order in which components are drawn and updated.
+         * @return A handle to the component, valid until the component is removed.
          */
-        void addComponent(Component *component, int zIndex);
+        ComponentHandle addComponent(Component *component, int zIndex);
 
         /**
-         * Remove a component from the scene.
+         * Remove a component from the scene. Its handle becomes invalid immediately,
+         * the component itself is removed (and destroyed) at the end of the frame.
          * @param component The component to remove.
          * @param destroy If true, the component will be destroyed.
          */
         void removeComponent(Component *component, bool destroy = false);
 
-        std::vector<Component *> getComponents() const { return components; }
+        /**
+         * Remove a component from the scene by its handle. Does nothing if the handle is no longer valid.
+         * @param handle The handle of the component to remove.
+         * @param destroy If true, the component will be destroyed.
+         */
+        void removeComponent(ComponentHandle handle, bool destroy = false);
+
+        /**
+         * @return The component the handle refers to, or nullptr if it has been removed from the scene.
+         */
+        Component *resolve(ComponentHandle handle) const;
+
+        /**
+         * @return A handle to a component in this scene, or a null handle if the component is not in this scene.
+         */
+        ComponentHandle getHandle(const Component *component) const;
+
+        /**
+         * @return A view of all components in the scene, ordered by z-index. The view does not copy the list,
+         * and the list is not reordered while the view is alive.
+         */
+        ComponentView getComponents() { return ComponentView(components, this); }
 
         /**
          * Deletes all components that have been marked for deletion.
          */
         void deleteComponents();
 
+        /**
+         * Restores the z-index order of the components if any z-index has changed. Called at the end of every frame.
+         */
+        void sortComponents();
+
+        /** @return The broadphase used to find colliding physics bodies in this scene. */
+        Broadphase &getBroadphase() { return broadphase; }
+
+        /** @return The physics world of this scene, used for point, rect and ray queries against its physics bodies. */
+        PhysicsWorld &getPhysicsWorld() { return physicsWorld; }
+
         /**
          * Called when this Scene is loaded.
          * @return true if the Scene was loaded successfully, false otherwise.
@@ -76,6 +123,8 @@ namespace fruitwork
         std::vector<Component *> components;
 
     private:
+        friend class ComponentView;
+
         struct ComponentDelete
         {
             Component *component;
@@ -84,6 +133,49 @@ namespace fruitwork
 
         std::vector<ComponentDelete> componentsToDelete;
 
+        /** The components of componentsToDelete, which are still in the list until it is compacted. */
+        std::unordered_set<Component *> removedComponents;
+
+        /** Components added while the scene was being iterated. */
+        std::vector<Component *> componentsToAdd;
+
+        /** The z-index generation the components were last sorted in. */
+        Uint32 sortedZIndexGeneration = 0;
+
+        /** The amount of live ComponentViews of this scene. */
+        int iterationDepth = 0;
+
+        void beginIteration() { iterationDepth++; }
+
+        /** Inserts the components added during iteration once the last view is gone. */
+        void endIteration();
+
+        void insertComponent(Component *component);
+
+        void insertComponents(const std::vector<Component *> &newComponents);
+
+        struct Slot
+        {
+            Component *component = nullptr;
+            Uint32 generation = 1;
+        };
+
+        /** The handle table. A component knows its own slot, so looking it up is O(1) both ways. */
+        std::vector<Slot> slots;
+        std::vector<Uint32> freeSlots;
+
+        /**
+         * Gives the component a slot in the handle table.
+         * @return true if the component has to be inserted into the list, false if it was removed earlier this frame and is still in it.
+         */
+        bool registerComponent(Component *component);
+
+        void releaseSlot(Component *component);
+
+        Broadphase broadphase;
+
+        PhysicsWorld physicsWorld;
+
         bool debugMode = false;
 
         fruitwork::Component *debugComponent;
@@ -2,8 +2,10 @@
 #define FRUITWORK_SESSION_H
 
 #include <vector>
+#include <unordered_set>
 #include "Component.h"
 #include "Scene.h"
+#include "Constants.h"
 #include <map>
 #include <functional>
 
@@ -13,12 +15,32 @@ namespace fruitwork
     class Session {
 
     public:
+        /** How long each phase of a frame took, in seconds. */
+        struct FrameTimings {
+            float events = 0;
+
+            /** Per-frame updates, scene changes and the removal and sorting of components at the end of the frame. */
+            float update = 0;
+
+            /** Fixed simulation steps and interpolation. */
+            float physics = 0;
+
+            float draw = 0;
+            float present = 0;
+        };
+
         /**
          * Add a component to the session.
          * @param component The component to add.
          */
         void addComponent(Component *component);
 
+        /**
+         * Add several components to the session at once. This sorts the session once instead of once per component.
+         * @param newComponents The components to add, in the order they should be added.
+         */
+        void addComponents(const std::vector<Component *> &newComponents);
+
         /**
          * Remove a component from the session.
          * @param component The component to remove.
@@ -47,11 +69,65 @@ namespace fruitwork
             return keyboardEventHandlers.erase(key) > 0;
         }
 
+        /** @return The time in seconds of a single simulation step. This is the value passed to Component::update(float). */
         float getElapsedTime() const
         {
             return elapsedTime;
         }
 
+        /** @return The real time in seconds the last frame took. */
+        float getFrameTime() const
+        {
+            return frameTime;
+        }
+
+        /** @return How far (0 to 1) the drawn frame is between the previous and the current simulation step. */
+        float getInterpolationAlpha() const
+        {
+            return interpolationAlpha;
+        }
+
+        /**
+         * Set the fixed rate the simulation is stepped at. Physics behaves the same regardless of the frame rate.
+         * @param hz The amount of simulation steps per second.
+         */
+        void setSimulationRate(int hz);
+
+        int getSimulationRate() const { return simulationRate; }
+
+        /**
+         * Set the maximum amount of simulation steps per frame. If the frame takes longer than this many steps,
+         * the simulation slows down instead of spending even more time catching up.
+         */
+        void setMaxSubsteps(int steps) { maxSubsteps = steps; }
+
+        int getMaxSubsteps() const { return maxSubsteps; }
+
+        /**
+         * Stop the session after a number of frames. Used to run a fixed amount of frames, e.g. for benchmarks.
+         * @param frames The amount of frames to run, 0 to run until the window is closed.
+         */
+        void setFrameLimit(int frames) { frameLimit = frames; }
+
+        int getFrameLimit() const { return frameLimit; }
+
+        /**
+         * Enable or disable frame pacing. Without pacing, frames are run back to back without sleeping,
+         * and every frame advances the simulation by exactly one step, so a run is the same regardless of how fast the machine is.
+         */
+        void setFramePacing(bool pacing) { framePacing = pacing; }
+
+        bool getFramePacing() const { return framePacing; }
+
+        /** @return How long each phase of the last frame took. */
+        const FrameTimings &getFrameTimings() const { return frameTimings; }
+
+        /**
+         * Register a function that is called at the end of every frame with the timings of that frame.
+         * @param listener The function to call, or nullptr to remove it.
+         */
+        void setFrameListener(const std::function<void(const FrameTimings &)> &listener) { frameListener = listener; }
+
         /**
          * Run the session.
          * @param startScene The scene to start the session with.
@@ -69,6 +145,9 @@ namespace fruitwork
         std::vector<Component *> components;
         std::vector<ComponentDelete> componentsToDelete;
 
+        /** The components of componentsToDelete, which are still in the list until it is compacted. */
+        std::unordered_set<Component *> removedComponents;
+
         std::map<SDL_Keycode, std::function<void()>> keyboardEventHandlers;
 
         /**
@@ -76,7 +155,30 @@ namespace fruitwork
          */
         void deleteComponents();
 
-        float elapsedTime = 0;
+        /** Restores the z-index order of the components if any z-index has changed. */
+        void sortComponents();
+
+        /** The z-index generation the components were last sorted in. */
+        Uint32 sortedZIndexGeneration = 0;
+
+        /**
+         * Advances the simulation of a scene by one fixed step.
+         * @param scene The scene to step.
+         */
+        void step(Scene *scene);
+
+        int simulationRate = constants::gSimulationRate;
+        int maxSubsteps = constants::gMaxSubsteps;
+
+        float elapsedTime = 1.0f / constants::gSimulationRate;
+        float frameTime = 0;
+        float interpolationAlpha = 0;
+
+        int frameLimit = 0;
+        bool framePacing = true;
+
+        FrameTimings frameTimings;
+        std::function<void(const FrameTimings &)> frameListener;
     };
 } // fruitwork
 
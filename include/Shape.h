@@ -1,21 +1,63 @@
 #ifndef FRUITWORK_SHAPE_H
 #define FRUITWORK_SHAPE_H
 
+#include <vector>
 #include "Component.h"
 
 namespace fruitwork
 {
 
+    /**
+     * A filled convex shape, drawn as a mesh through the RenderQueue.
+     * The mesh is built once from the outline of the shape, and only rebuilt when its size, color or outline changes.
+     * Rotation is applied to the vertices while drawing, so rotating a shape doesn't rebuild it.
+     */
     class Shape : public Component {
     public:
-        void setColor(SDL_Color c) { this->color = c; }
+        void setColor(SDL_Color c);
 
-        void draw() const override = 0;
+        SDL_Color getColor() const { return color; }
+
+        /** Fade the edges out over a pixel, so rotated and round edges don't look jagged. */
+        void setAntialiased(bool a);
+
+        bool isAntialiased() const { return antialiased; }
+
+        void draw() const override;
+
+        bool isDrawBatched() const override { return true; }
 
     protected:
         Shape(int x, int y, int w, int h, SDL_Color c);
 
+        /**
+         * Build the outline of the shape. Only called when the mesh has to be rebuilt.
+         * @param w The width of the shape.
+         * @param h The height of the shape.
+         * @param outline The corners of a convex polygon in clockwise order, relative to the top left of the shape.
+         */
+        virtual void buildOutline(int w, int h, std::vector<SDL_FPoint> &outline) const = 0;
+
+        /** Rebuild the mesh before the next draw, for subclasses whose outline changed. */
+        void invalidateGeometry() { geometryDirty = true; }
+
+    private:
+        /** Baked into the mesh, only changed through setColor so the mesh is rebuilt. */
         SDL_Color color;
+
+        bool antialiased = false;
+
+        /** The mesh relative to the top left of the shape, unrotated. */
+        mutable std::vector<SDL_Vertex> vertices;
+        mutable std::vector<int> indices;
+
+        mutable bool geometryDirty = true;
+
+        /** The size the mesh was built for. */
+        mutable SDL_Point geometrySize = {-1, -1};
+
+        /** Tessellate the outline into the mesh. */
+        void buildGeometry(int w, int h) const;
     };
 
 } // fruitwork
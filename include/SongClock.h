@@ -0,0 +1,106 @@
+#ifndef FRUITWORK_SONG_CLOCK_H
+#define FRUITWORK_SONG_CLOCK_H
+
+#include <string>
+#include <memory>
+#include <mutex>
+#include <SDL.h>
+#include <SDL_mixer.h>
+
+namespace fruitwork
+{
+
+    /**
+     * Plays a song and tells how far into it the listener is, to time notes and judge hits against what is heard.
+     * The mixer's post-mix callback counts the samples it mixed while the song played. Between two callbacks the time is
+     * extrapolated with the performance counter, and the result is slowly pulled towards the audio position instead of jumping,
+     * so the time is smooth and never goes back while playing.
+     * The clock takes the post-mix callback of SDL_mixer, which only has one.
+     */
+    class SongClock {
+    public:
+        static SongClock *getInstance();
+
+        /**
+         * Play a song from the start, replacing the current one.
+         * @param path The path of the song, e.g. from ResourceManager::getAudioPath.
+         * @param loops How many times to repeat it, -1 forever. The time keeps counting up over the repeats.
+         * @return If the song could be loaded and started.
+         */
+        bool play(const std::string &path, int loops = 0);
+
+        void pause();
+
+        void resume();
+
+        /** Stop the song, the time stays where it was until the next song is played. */
+        void stop();
+
+        /** @return If a song is playing and not paused. */
+        bool isPlaying() const;
+
+        /**
+         * @return How far into the song the listener is, in microseconds.
+         * Negative right after play, until the first mixed audio reaches the speakers.
+         */
+        Sint64 getTime();
+
+        /** @return The time in seconds, for gameplay code that works in seconds. */
+        double getSeconds() { return (double) getTime() / 1000000.0; }
+
+        /**
+         * @param microseconds Latency after the audio device, e.g. of a bluetooth headset or a user calibration,
+         * subtracted from the time.
+         */
+        void setOutputLatency(Sint64 microseconds) { outputLatency = microseconds; }
+
+        Sint64 getOutputLatency() const { return outputLatency; }
+
+    private:
+        SongClock() = default;
+
+        /** The time differs from the audio position by more than this after a stall or a seek, catch up at once. */
+        static const Sint64 RESYNC_THRESHOLD = 50000;
+
+        /** The fraction of the difference to the audio position corrected on every read. */
+        static constexpr double SMOOTHING = 0.05;
+
+        static void onPostMix(void *clock, Uint8 *stream, int length);
+
+        std::shared_ptr<Mix_Music> music;
+
+        /** Guards the audio position, which is written by the audio thread. */
+        mutable std::mutex mutex;
+
+        /** If a song was played and not stopped. The callback also skips buffers mixed while the music is paused. */
+        bool counting = false;
+
+        /** Sample frames of the song mixed so far. */
+        Uint64 mixedFrames = 0;
+
+        /** The sample frame of the song that started to be heard at the last callback, negative before the song is heard. */
+        Sint64 heardFrames = 0;
+
+        /** The size of the device buffer in sample frames, the audio mixed by a callback is heard after the buffer playing now. */
+        Uint64 bufferFrames = 0;
+
+        /** The performance counter at the last callback that counted, or when the song was played. */
+        Uint64 callbackCounter = 0;
+
+        int frequency = 0;
+        int frameSize = 0;
+
+        /** Main thread only. The performance counter time minus the song time, and the last time returned. */
+        Sint64 offset = 0;
+        Sint64 lastTime = 0;
+        bool synced = false;
+
+        Sint64 outputLatency = 0;
+
+        /** @return The performance counter in microseconds. */
+        static Sint64 getCounterTime(Uint64 counter);
+    };
+
+} // fruitwork
+
+#endif //FRUITWORK_SONG_CLOCK_H
@@ -4,6 +4,9 @@
 #include <string>
 #include <SDL.h>
 #include "Component.h"
+#include "ResourceManager.h"
+#include "TextureAtlas.h"
+#include "CollisionMask.h"
 
 namespace fruitwork
 {
@@ -13,16 +16,27 @@ namespace fruitwork
     public:
         /**
          * @brief Create a new Sprite instance.
-         * @param keepSurface Whether to keep the surface after creating the texture.
-         * The surface should be kept if you need collision detection on pixel level.
+         * @param keepSurface Whether to build a collision mask of the image, needed for collision detection on pixel level.
+         * The mask is shared with every sprite of the same image, the pixels themselves are not kept.
          * @return
          */
         static Sprite *getInstance(int x, int y, int w, int h, const std::string &texturePath, bool keepSurface = false);
 
         static Sprite *getInstance(int x, int y, int w, int h, SDL_Texture *texture);
 
+        static Sprite *getInstance(int x, int y, int w, int h, const TextureAtlas::Region &region);
+
+        /**
+         * Create a sprite of an image in the texture atlas.
+         * @param imageName The name of the image, relative to the images directory (e.g. "fruit-orange.png").
+         * If the image is not in the atlas it is loaded on its own.
+         */
+        static Sprite *getAtlasInstance(int x, int y, int w, int h, const std::string &imageName);
+
         void draw() const override;
 
+        bool isDrawBatched() const override { return true; }
+
         void update(float elapsedTime) override;
 
         /** Apply color modulation to the sprite. */
@@ -51,6 +65,15 @@ namespace fruitwork
 
         virtual void setTexture(SDL_Texture *texture);
 
+        /** Draw a region of an atlas page instead of a whole texture. */
+        virtual void setRegion(const TextureAtlas::Region &region);
+
+        /** Draw an image of the texture atlas, loaded on its own if it is not in the atlas. */
+        void setRegion(const std::string &imageName);
+
+        /** @return The size of the drawn image, for atlas regions the size before their transparent borders were trimmed. */
+        SDL_Point getImageSize() const;
+
         /**
          * Checks if the rect of the sprite is colliding with the rect of another sprite.
          * @param other The other sprite to check collision with.
@@ -61,26 +84,44 @@ namespace fruitwork
 
         /**
          * Checks if the rect of the sprite is colliding with the pixels of another sprite.
-         * To use this you need to keep the surface when creating the sprite.
+         * To use this both sprites need keepSurface when they are created, so they have a collision mask.
+         * Sprites drawn at another size than their image are tested at the drawn size. Rotation and flipping are ignored.
          * @param other The other sprite to check collision with.
          * @param alpha The alpha value to consider as transparent. Default is 10 (basically invisible).
          * @return true if the rects are colliding, false otherwise.
          */
         bool pixelCollidesWith(const Sprite *other, Uint8 alpha = 10) const;
 
-        ~Sprite() override;
+        ~Sprite() override = default;
 
     protected:
         Sprite(int x, int y, int w, int h, const std::string &texturePath, bool keepSurface = false);
 
         Sprite(int x, int y, int w, int h, SDL_Texture *texture);
 
+        Sprite(int x, int y, int w, int h, const TextureAtlas::Region &region);
+
+        /** The texture that is drawn. Textures passed in directly are not owned by the sprite. */
         SDL_Texture *spriteTexture = nullptr;
-        SDL_Surface *surface = nullptr;
 
-        /**  If true, the texture will be destroyed when the sprite is destroyed. */
-        bool isTextureOwner = true; // TODO replace with smart pointers?
-        bool isSurfaceOwner = true;
+        /** Keeps a texture loaded from a path alive, shared with every other user of the same file. */
+        ResourceManager::TextureHandle textureHandle;
+
+        /** The path of the texture, if it was loaded from one. */
+        std::string texturePath;
+
+        /** The opaque pixels of the texture, only built if asked for (for pixel collisions). */
+        mutable CollisionMask::Handle collisionMask;
+
+        /** The collision mask scaled to the size of the rect, if the sprite is not drawn at the size of its image. */
+        mutable CollisionMask::Handle scaledCollisionMask;
+
+        /** @return The collision mask at the size of the rect, nullptr if the sprite has none. */
+        const CollisionMask *getCollisionMask(Uint8 alpha) const;
+
+        /** The part of the texture that is drawn, if the sprite is an atlas region. */
+        TextureAtlas::Region region{};
+        bool isRegion = false;
 
     private:
         SDL_Color colorMod = {255, 255, 255, 255};
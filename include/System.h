@@ -4,6 +4,7 @@
 #include <SDL.h>
 #include <SDL_ttf.h>
 #include "Scene.h"
+#include "ResourceManager.h"
 
 namespace fruitwork
 {
@@ -18,6 +19,18 @@ namespace fruitwork
 
         SDL_Window *getWindow() const { return window; }
 
+        /** @return The size of the window in pixels, updated whenever the window is resized. */
+        const SDL_Point &getWindowSize() const { return windowSize; }
+
+        /**
+         * @return A number that changes every time the window is resized.
+         * Layouts calculated in an older generation are outdated.
+         */
+        Uint32 getLayoutGeneration() const { return layoutGeneration; }
+
+        /** Called when the window has been resized, invalidating all layouts relative to it. */
+        void onWindowResized();
+
         TTF_Font *getFont() const { return font; }
 
         void setNextScene(Scene *scene);
@@ -36,7 +49,11 @@ namespace fruitwork
         SDL_Window *window;
         SDL_Renderer *renderer;
 
+        SDL_Point windowSize = {0, 0};
+        Uint32 layoutGeneration = 1;
+
         TTF_Font *font;
+        ResourceManager::FontHandle fontHandle;
 
         Scene *currentScene = nullptr;
         Scene *nextScene = nullptr;
@@ -0,0 +1,142 @@
+#ifndef FRUITWORK_TEXT_AREA_H
+#define FRUITWORK_TEXT_AREA_H
+
+#include <string>
+#include <vector>
+#include "Component.h"
+#include "GapBuffer.h"
+#include "GlyphAtlas.h"
+#include "Constants.h"
+
+namespace fruitwork
+{
+
+    /**
+     * A multi-line text editor.
+     * The text is kept in a gap buffer and every line keeps its own layout, so an edit only lays out the lines it touched.
+     * Only the lines that fit in the text area are laid out and drawn, long texts scroll with the mouse wheel or caret.
+     */
+    class TextArea : public Component {
+    public:
+        static TextArea *getInstance(int x, int y, int w, int h);
+
+        void draw() const override;
+
+        bool isDrawBatched() const override { return true; }
+
+        ~TextArea() override;
+
+        void update() override;
+
+        void onMouseDown(const SDL_Event &) override;
+
+        void onMouseWheel(const SDL_Event &) override;
+
+        void onTextInput(const SDL_Event &) override;
+
+        void onKeyDown(const SDL_Event &) override;
+
+        /** Replace the whole text and move the caret to the start. */
+        void setText(const std::string &t);
+
+        std::string getText() const { return buffer.toString(); }
+
+        int getLineCount() const { return (int) lineStarts.size(); }
+
+    protected:
+        TextArea(int x, int y, int w, int h);
+
+    private:
+#pragma region Text properties
+
+        struct Line {
+            GlyphAtlas::TextLayout layout;
+
+            /** Whether the text of the line changed since it was laid out. */
+            bool dirty = true;
+        };
+
+        GapBuffer buffer;
+
+        /** The byte position every line starts at, the first is always 0. */
+        std::vector<size_t> lineStarts = {0};
+
+        /** The layout of every line, laid out when it is first drawn after a change. */
+        mutable std::vector<Line> lines = std::vector<Line>(1);
+
+        /** Reused when copying a line out of the buffer. */
+        mutable std::string lineText;
+
+        /** The first line that is shown. */
+        int scrollLine = 0;
+
+        int lineHeight;
+
+        bool isFocused = false;
+
+        bool isHovered = false;
+
+        /** Insert text at a position, keeping the line starts and layouts in sync. */
+        void insert(size_t position, const char *text, size_t length);
+
+        /** Erase the text between two positions, keeping the line starts and layouts in sync. */
+        void erase(size_t from, size_t to);
+
+        /** @return The line a position is on. */
+        int getLineAt(size_t position) const;
+
+        /** @return The position of the end of a line, before its newline. */
+        size_t getLineEnd(int line) const;
+
+        /** @return The x offset of a position relative to the start of its line. */
+        int getOffsetInLine(int line, size_t position) const;
+
+        /** @return The position on a line closest to an x offset relative to the start of the line. */
+        size_t getPositionInLine(int line, int x) const;
+
+        /** @return The amount of lines that fit in the text area. */
+        int getVisibleLineCount() const;
+
+        /** Keep the first shown line between the first line and the last one that still fills the text area. */
+        void clampScroll();
+
+#pragma endregion
+
+#pragma region Caret properties
+
+        /** @see fruitwork::InputField::CARET_BLINK_INTERVAL */
+        const int CARET_BLINK_INTERVAL = (double) constants::gFps / 1.88; // NOLINT
+        int caretBlinkCounter = 0;
+        bool caretVisible = true;
+
+        /** The byte position of the caret, always at the start of a character. */
+        size_t caretPosition = 0;
+
+        /** The x offset of the caret relative to the start of its line. */
+        int caretOffset = 0;
+
+        /** The x offset moving up and down tries to keep, -1 when the caret moved otherwise. */
+        int preferredOffset = -1;
+
+        /**
+         * Move the caret, scroll it into view and show it.
+         * @param position The new caret position.
+         * @param keepPreferredOffset true when moving up or down, so the caret returns to its column on longer lines.
+         */
+        void moveCaret(size_t position, bool keepPreferredOffset = false);
+
+        /** Move the caret up or down a number of lines, negative for up. */
+        void moveCaretLines(int count);
+
+        /** @return The start of the character before a position. */
+        size_t getPreviousCharacter(size_t position) const;
+
+        /** @return The start of the character after a position. */
+        size_t getNextCharacter(size_t position) const;
+
+#pragma endregion
+    };
+
+} // fruitwork
+
+#endif //FRUITWORK_TEXT_AREA_H
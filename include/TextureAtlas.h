@@ -0,0 +1,79 @@
+#ifndef FRUITWORK_TEXTURE_ATLAS_H
+#define FRUITWORK_TEXTURE_ATLAS_H
+
+#include <SDL.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "ResourceManager.h"
+
+namespace fruitwork
+{
+
+    /**
+     * Images packed into a few large textures by the atlas packer (make atlas), so drawing many different sprites
+     * doesn't switch textures for every one of them.
+     * The index (atlas.txt) has one line per page ("page <file>") and one line per image:
+     * "region <page> <x> <y> <w> <h> <offsetX> <offsetY> <originalW> <originalH> <name>".
+     * Images are stored with their transparent borders trimmed, offset and original size restore them when drawn.
+     */
+    class TextureAtlas {
+    public:
+        struct Region {
+            /** The page the image is on. */
+            ResourceManager::TextureHandle page;
+
+            /** Where the trimmed image is on the page. */
+            SDL_Rect source;
+
+            /** Where the trimmed image was in the original image. */
+            SDL_Point offset;
+
+            /** The size of the original image, before trimming. */
+            int originalWidth;
+            int originalHeight;
+        };
+
+        /** @return The atlas of the engine's images, loaded from resources/atlas/ on first use. */
+        static TextureAtlas *getInstance();
+
+        /**
+         * Find an image by name, in the atlas if it was packed, otherwise as its own texture.
+         * This way sprites referencing images by name keep working when the atlas was not built.
+         * @param name The name of the image, relative to the images directory (e.g. "fruit-orange.png").
+         * @return The region of the image, its page is empty if the image could not be loaded.
+         */
+        static Region getImage(const std::string &name);
+
+        /** @return A region covering a whole texture. */
+        static Region getWholeTexture(const ResourceManager::TextureHandle &texture);
+
+        /**
+         * Load an atlas index and its pages. Regions of a previously loaded index are replaced.
+         * @param indexPath The path of the atlas.txt written by the atlas packer.
+         * @return true if the atlas was loaded.
+         */
+        bool load(const std::string &indexPath);
+
+        /**
+         * @param name The name of the image, relative to the images directory (e.g. "fruit-orange.png").
+         * @return The region of the image, or nullptr if it is not in the atlas.
+         */
+        const Region *getRegion(const std::string &name) const;
+
+        /** @return The amount of images in the atlas. */
+        int size() const { return (int) regions.size(); }
+
+    private:
+        TextureAtlas() = default;
+
+        /** Create the atlas and load its index, if there is one. */
+        static TextureAtlas *create();
+
+        std::vector<ResourceManager::TextureHandle> pages;
+        std::unordered_map<std::string, Region> regions;
+    };
+
+} // fruitwork
+
+#endif //FRUITWORK_TEXTURE_ATLAS_H
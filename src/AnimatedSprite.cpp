@@ -1,77 +1,52 @@
 #include "AnimatedSprite.h"
-#include "System.h"
-#include "Constants.h"
-#include <sys/stat.h>
-#include <SDL_image.h>
 
 namespace fruitwork
 {
-    /**
-    * @see https://stackoverflow.com/a/12774387
-    */
-    inline bool file_exists(const std::string &path)
+    AnimatedSprite *AnimatedSprite::getInstance(int x, int y, int w, int h, const std::string &animationPath, Uint32 animationSpeed)
     {
-        struct stat buffer{};
-        return (stat(path.c_str(), &buffer) == 0);
+        return new AnimatedSprite(x, y, w, h, AnimationClip::getInstance(animationPath, animationSpeed));
     }
 
-    AnimatedSprite *AnimatedSprite::getInstance(int x, int y, int w, int h, const std::string &animationPath, Uint32 animationSpeed)
+    AnimatedSprite *AnimatedSprite::getAtlasInstance(int x, int y, int w, int h, const std::string &animationName, Uint32 animationSpeed)
     {
-        return new AnimatedSprite(x, y, w, h, animationPath, animationSpeed);
+        return new AnimatedSprite(x, y, w, h, AnimationClip::getAtlasInstance(animationName, animationSpeed));
     }
 
-    AnimatedSprite::AnimatedSprite(int x, int y, int w, int h, const std::string &animationPath, Uint32 animationSpeed) :
-            Sprite(x, y, w, h, nullptr), animationName(animationPath), animationSpeed(animationSpeed)
+    AnimatedSprite *AnimatedSprite::getInstance(int x, int y, int w, int h, const AnimationClip::Handle &clip)
     {
-        int i = 0;
-        while (true)
-        {
-            std::string path = animationPath;
-            std::string frameNumber = std::to_string(i);
-            path.replace(path.find("{n}"), 3, frameNumber);
-            if (file_exists(path))
-            {
-                SDL_Surface *surface = IMG_Load(path.c_str());
-                if (surface == nullptr)
-                    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to load animation image: %s", path.c_str());
-                SDL_Texture *texture = SDL_CreateTextureFromSurface(sys.getRenderer(), surface);
-                SDL_FreeSurface(surface);
-                frames.push_back(texture);
-                i++;
-            }
-            else
-            {
-                break;
-            }
-        }
+        return new AnimatedSprite(x, y, w, h, clip);
+    }
 
-        if (frames.empty())
-            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
-                         "Failed to load animation: %s. If nothing else is logged, the path might be incorrect or a start frame (N=0) might be missing.", animationPath.c_str());
+    AnimatedSprite::AnimatedSprite(int x, int y, int w, int h, AnimationClip::Handle clip) : Sprite(x, y, w, h, nullptr)
+    {
+        setClip(clip);
+    }
 
-        frameCount = (int) frames.size();
+    void AnimatedSprite::setClip(const AnimationClip::Handle &newClip)
+    {
+        clip = newClip;
+        frame = -1;
+        update();
+    }
+
+    void AnimatedSprite::restart()
+    {
+        startTime = SDL_GetTicks64();
+        update();
     }
 
     void AnimatedSprite::update()
     {
-        if (frameCount == 0)
+        if (clip == nullptr || clip->getFrameCount() == 0)
             return;
 
-        Uint32 ticks = SDL_GetTicks();
+        int current = clip->getFrameAt(SDL_GetTicks64() - startTime);
 
-        if (ticks - lastFrame > animationSpeed)
+        if (current != frame)
         {
-            frame = (frame + 1) % frameCount;
-            lastFrame = ticks;
+            frame = current;
+            setRegion(clip->getFrame(frame).region);
         }
-
-        spriteTexture = frames[frame];
-    }
-
-    AnimatedSprite::~AnimatedSprite()
-    {
-        for (SDL_Texture *f: frames)
-            SDL_DestroyTexture(f);
     }
 
-} // fruitwork
\ No newline at end of file
+} // fruitwork
@@ -0,0 +1,173 @@
+#include <algorithm>
+#include "AnimationClip.h"
+#include "Profiler.h"
+
+namespace fruitwork
+{
+    std::unordered_map<std::string, std::weak_ptr<const AnimationClip>> AnimationClip::clips;
+
+    /** @return The name of a numbered frame, {n} replaced with its number. */
+    static std::string getFrameName(const std::string &animationName, int frame)
+    {
+        std::string name = animationName;
+        size_t number = name.find("{n}");
+        if (number != std::string::npos)
+            name.replace(number, 3, std::to_string(frame));
+
+        return name;
+    }
+
+    AnimationClip::AnimationClip(std::vector<Frame> frames) : frames(std::move(frames))
+    {
+        Uint64 end = 0;
+        for (const Frame &frame: this->frames)
+        {
+            end += frame.duration;
+            frameEnds.push_back(end);
+        }
+    }
+
+    AnimationClip::Handle AnimationClip::getCached(const std::string &key, const std::function<std::vector<Frame>()> &loadFrames)
+    {
+        auto cached = clips.find(key);
+        Handle clip = cached != clips.end() ? cached->second.lock() : nullptr;
+        if (clip != nullptr)
+            return clip;
+
+        FRUITWORK_PROFILE_ZONE("AnimationClip: load clip");
+
+        // loading may look up other clips, so the map is only written to once the frames are loaded
+        clip = std::make_shared<AnimationClip>(loadFrames());
+
+        // a clip without frames failed to load, it isn't cached so the next lookup tries again
+        if (clip->getFrameCount() > 0)
+            clips[key] = clip;
+
+        return clip;
+    }
+
+    void AnimationClip::releaseUnused()
+    {
+        for (auto it = clips.begin(); it != clips.end();)
+        {
+            if (it->second.expired())
+                it = clips.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    AnimationClip::Handle AnimationClip::getInstance(const std::string &animationPath, Uint32 frameDuration)
+    {
+        return getCached("files:" + animationPath + ":" + std::to_string(frameDuration), [&]()
+        {
+            std::vector<Frame> frames;
+
+            while (true)
+            {
+                std::string path = getFrameName(animationPath, (int) frames.size());
+                if (!ResourceManager::exists(path))
+                    break;
+
+                ResourceManager::TextureHandle texture = ResourceManager::getTexture(path);
+                if (texture == nullptr)
+                    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to load animation image: %s", path.c_str());
+
+                frames.push_back({TextureAtlas::getWholeTexture(texture), frameDuration});
+
+                // a path without {n} is a single frame
+                if (path == animationPath)
+                    break;
+            }
+
+            if (frames.empty())
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
+                             "Failed to load animation: %s. If nothing else is logged, the path might be incorrect or a start frame (N=0) might be missing.", animationPath.c_str());
+
+            return frames;
+        });
+    }
+
+    AnimationClip::Handle AnimationClip::getAtlasInstance(const std::string &animationName, Uint32 frameDuration)
+    {
+        return getCached("atlas:" + animationName + ":" + std::to_string(frameDuration), [&]()
+        {
+            std::vector<Frame> frames;
+            TextureAtlas *atlas = TextureAtlas::getInstance();
+
+            while (const TextureAtlas::Region *region = atlas->getRegion(getFrameName(animationName, (int) frames.size())))
+            {
+                frames.push_back({*region, frameDuration});
+
+                if (animationName.find("{n}") == std::string::npos)
+                    break;
+            }
+
+            // not packed, load the images on their own
+            if (frames.empty())
+                frames = getInstance(ResourceManager::getTexturePath(animationName), frameDuration)->frames;
+
+            return frames;
+        });
+    }
+
+    AnimationClip::Handle AnimationClip::getSheetInstance(const std::string &imageName, int columns, int rows, const std::vector<Uint32> &frameDurations)
+    {
+        std::string key = "sheet:" + imageName + ":" + std::to_string(columns) + "x" + std::to_string(rows);
+        for (Uint32 duration: frameDurations)
+            key += ":" + std::to_string(duration);
+
+        return getCached(key, [&]()
+        {
+            std::vector<Frame> frames;
+            if (columns <= 0 || rows <= 0)
+                return frames;
+
+            // the cells are in the original image, the sheet may have been trimmed when it was packed
+            TextureAtlas::Region sheet = TextureAtlas::getImage(imageName);
+            int cellWidth = sheet.originalWidth / columns, cellHeight = sheet.originalHeight / rows;
+            SDL_Rect trimmed = {sheet.offset.x, sheet.offset.y, sheet.source.w, sheet.source.h};
+
+            for (int i = 0; i < (int) frameDurations.size() && i < columns * rows; i++)
+            {
+                SDL_Rect cell = {(i % columns) * cellWidth, (i / columns) * cellHeight, cellWidth, cellHeight};
+
+                // the part of the cell that was not trimmed away, a fully trimmed cell is an empty frame
+                SDL_Rect visible = {cell.x, cell.y, 0, 0};
+                SDL_IntersectRect(&cell, &trimmed, &visible);
+
+                TextureAtlas::Region region = sheet;
+                region.source = {sheet.source.x + visible.x - sheet.offset.x, sheet.source.y + visible.y - sheet.offset.y, visible.w, visible.h};
+                region.offset = {visible.x - cell.x, visible.y - cell.y};
+                region.originalWidth = cellWidth;
+                region.originalHeight = cellHeight;
+
+                frames.push_back({region, frameDurations[i]});
+            }
+
+            return frames;
+        });
+    }
+
+    AnimationClip::Handle AnimationClip::getSheetInstance(const std::string &imageName, int columns, int rows, int frameCount, Uint32 frameDuration)
+    {
+        return getSheetInstance(imageName, columns, rows, std::vector<Uint32>(std::max(0, frameCount), frameDuration));
+    }
+
+    AnimationClip::Handle AnimationClip::create(std::vector<Frame> frames)
+    {
+        return std::make_shared<AnimationClip>(std::move(frames));
+    }
+
+    int AnimationClip::getFrameAt(Uint64 time) const
+    {
+        Uint64 length = getLength();
+        if (length == 0)
+            return 0;
+
+        // the first frame that ends after the time
+        auto it = std::upper_bound(frameEnds.begin(), frameEnds.end(), time % length);
+        return (int) (it - frameEnds.begin());
+    }
+
+} // fruitwork
@@ -0,0 +1,158 @@
+#include <cstring>
+#include "AssetArchive.h"
+#include "Profiler.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fruitwork
+{
+    /**
+     * Relative to the working directory like constants::gResPath, since the paths in the archive are the resource paths.
+     * Not a std::string: the archive may be opened during static initialization, e.g. for System's cursors.
+     */
+    static const char *ARCHIVE_PATH = "resources.pak";
+
+    AssetArchive *AssetArchive::getInstance()
+    {
+        // initialized once even if the first lookup comes from an AssetLoader worker and the main thread at the same time
+        static AssetArchive *instance = create();
+        return instance;
+    }
+
+    AssetArchive *AssetArchive::create()
+    {
+        auto *archive = new AssetArchive();
+
+        if (archive->map(ARCHIVE_PATH))
+            SDL_Log("Asset archive mapped: %d files in %s", archive->getFileCount(), ARCHIVE_PATH);
+        else
+            SDL_Log("No asset archive at %s, resources are opened one by one. Run make pack to build it.", ARCHIVE_PATH);
+
+        return archive;
+    }
+
+    bool AssetArchive::map(const char *archivePath)
+    {
+        FRUITWORK_PROFILE_ZONE("AssetArchive::map");
+
+        const Uint8 *mapped = nullptr;
+        size_t size = 0;
+
+#ifdef _WIN32
+        HANDLE file = CreateFileA(archivePath, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            return false;
+
+        LARGE_INTEGER fileSize;
+        if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0)
+        {
+            size = (size_t) fileSize.QuadPart;
+
+            // the view keeps the mapping alive, the handles can go right away
+            HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping != nullptr)
+            {
+                mapped = (const Uint8 *) MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+                CloseHandle(mapping);
+            }
+        }
+        CloseHandle(file);
+#else
+        int file = ::open(archivePath, O_RDONLY);
+        if (file < 0)
+            return false;
+
+        struct stat status{};
+        if (fstat(file, &status) == 0 && status.st_size > 0)
+        {
+            size = (size_t) status.st_size;
+
+            void *view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+            if (view != MAP_FAILED)
+                mapped = (const Uint8 *) view;
+        }
+        close(file);
+#endif
+
+        if (mapped == nullptr)
+        {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to map asset archive %s", archivePath);
+            return false;
+        }
+
+        Header read{};
+        if (size >= sizeof(Header))
+            std::memcpy(&read, mapped, sizeof(Header));
+
+        size_t tableEnd = sizeof(Header) + (size_t) read.slotCount * sizeof(Slot) + (size_t) read.entryCount * sizeof(Entry);
+        bool valid = read.magic == MAGIC && read.version == VERSION && read.slotCount >= 2
+                     && (read.slotCount & (read.slotCount - 1)) == 0 && read.entryCount < read.slotCount && tableEnd <= size;
+
+        if (!valid)
+        {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Invalid asset archive %s, rebuild it with make pack", archivePath);
+#ifdef _WIN32
+            UnmapViewOfFile(mapped);
+#else
+            munmap((void *) mapped, size);
+#endif
+            return false;
+        }
+
+        data = mapped;
+        length = size;
+        header = read;
+
+        // the header and the slots are a multiple of 8 bytes, so the entries are aligned in the page aligned mapping
+        slots = (const Slot *) (data + sizeof(Header));
+        entries = (const Entry *) (slots + header.slotCount);
+
+        return true;
+    }
+
+    const AssetArchive::Entry *AssetArchive::find(const std::string &path) const
+    {
+        if (data == nullptr)
+            return nullptr;
+
+        Uint64 pathHash = hash(path.data(), path.size());
+        Uint32 mask = header.slotCount - 1;
+
+        // the table is never full, so probing always ends at an empty slot
+        for (Uint32 slot = (Uint32) pathHash & mask;; slot = (slot + 1) & mask)
+        {
+            Slot index = slots[slot];
+            if (index == 0 || index > header.entryCount)
+                return nullptr;
+
+            const Entry *entry = &entries[index - 1];
+            if (entry->hash == pathHash && entry->pathLength == path.size()
+                && (Uint64) entry->pathOffset + entry->pathLength <= length
+                && std::memcmp(data + entry->pathOffset, path.data(), path.size()) == 0)
+                return entry;
+        }
+    }
+
+    SDL_RWops *AssetArchive::open(const std::string &path) const
+    {
+        const Entry *entry = find(path);
+        if (entry == nullptr)
+            return nullptr;
+
+        if (entry->offset + entry->size > length)
+        {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "%s points past the end of the asset archive", path.c_str());
+            return nullptr;
+        }
+
+        return SDL_RWFromConstMem(data + entry->offset, (int) entry->size);
+    }
+
+} // fruitwork
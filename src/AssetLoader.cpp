@@ -0,0 +1,225 @@
+#include <algorithm>
+#include <SDL_image.h>
+#include "AssetLoader.h"
+#include "Profiler.h"
+
+namespace fruitwork
+{
+    AssetLoader *AssetLoader::getInstance()
+    {
+        // never destroyed, the system shuts the workers down before SDL quits
+        static auto *instance = new AssetLoader();
+        return instance;
+    }
+
+    AssetLoader::Request<ResourceManager::TextureHandle> AssetLoader::loadTexture(const std::string &path,
+                                                                                std::function<void(const ResourceManager::TextureHandle &)> onLoaded)
+    {
+        auto pending = std::make_shared<Pending<ResourceManager::TextureHandle>>();
+        pending->onLoaded = std::move(onLoaded);
+
+        auto job = std::make_shared<Job>();
+
+        // already loaded, only the callback is left to do
+        ResourceManager::TextureHandle cached = ResourceManager::findTexture(path);
+        if (cached != nullptr)
+        {
+            job->finish = [this, pending, cached]() { complete(*pending, cached); };
+            enqueue(job);
+            return pending;
+        }
+
+        auto decoded = std::make_shared<ResourceManager::SurfaceHandle>();
+
+        job->decode = [path, decoded]()
+        {
+            FRUITWORK_PROFILE_ZONE("AssetLoader: decode image");
+
+            SDL_Surface *surface = IMG_Load_RW(ResourceManager::openFile(path), 1);
+            if (surface == nullptr)
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to load image %s: %s", path.c_str(), IMG_GetError());
+            else
+                *decoded = ResourceManager::SurfaceHandle(surface, SDL_FreeSurface);
+        };
+
+        job->finish = [this, path, decoded, pending]()
+        {
+            ResourceManager::TextureHandle texture = *decoded != nullptr ? ResourceManager::addTexture(path, decoded->get()) : nullptr;
+            decoded->reset();
+            complete(*pending, texture);
+        };
+
+        enqueue(job);
+        return pending;
+    }
+
+    AssetLoader::Request<ResourceManager::FontHandle> AssetLoader::loadFont(const std::string &path, int size, int style,
+                                                                          std::function<void(const ResourceManager::FontHandle &)> onLoaded)
+    {
+        auto pending = std::make_shared<Pending<ResourceManager::FontHandle>>();
+        pending->onLoaded = std::move(onLoaded);
+
+        // SDL_ttf shares one FreeType library between all fonts, which must not be used from several threads
+        auto job = std::make_shared<Job>();
+        job->finish = [this, path, size, style, pending]() { complete(*pending, ResourceManager::getFont(path, size, style)); };
+
+        enqueue(job);
+        return pending;
+    }
+
+    AssetLoader::Request<AssetLoader::SoundHandle> AssetLoader::loadSound(const std::string &path, std::function<void(const SoundHandle &)> onLoaded)
+    {
+        auto pending = std::make_shared<Pending<SoundHandle>>();
+        pending->onLoaded = std::move(onLoaded);
+
+        auto job = std::make_shared<Job>();
+
+        // already loaded, only the callback is left to do
+        SoundHandle cached = ResourceManager::findSound(path);
+        if (cached != nullptr)
+        {
+            job->finish = [this, pending, cached]() { complete(*pending, cached); };
+            enqueue(job);
+            return pending;
+        }
+
+        auto decoded = std::make_shared<SoundHandle>();
+
+        job->decode = [path, decoded]()
+        {
+            FRUITWORK_PROFILE_ZONE("AssetLoader: decode sound");
+
+            Mix_Chunk *chunk = Mix_LoadWAV_RW(ResourceManager::openFile(path), 1);
+            if (chunk == nullptr)
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to load sound %s: %s", path.c_str(), Mix_GetError());
+            else
+                *decoded = SoundHandle(chunk, Mix_FreeChunk);
+        };
+
+        job->finish = [this, path, decoded, pending]() { complete(*pending, ResourceManager::addSound(path, *decoded)); };
+
+        enqueue(job);
+        return pending;
+    }
+
+    void AssetLoader::update()
+    {
+        if (requested == 0)
+            return;
+
+        FRUITWORK_PROFILE_ZONE("AssetLoader::update");
+
+        Uint64 start = SDL_GetTicks64();
+        do
+        {
+            std::shared_ptr<Job> job;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (finishQueue.empty())
+                    break;
+
+                job = finishQueue.front();
+                finishQueue.pop_front();
+            }
+
+            job->finish();
+        } while (SDL_GetTicks64() - start < frameBudget);
+
+        // idle, the progress of the next requests starts from 0
+        if (finished == requested)
+        {
+            requested = 0;
+            finished = 0;
+        }
+    }
+
+    void AssetLoader::shutdown()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+            decodeQueue.clear();
+            finishQueue.clear();
+        }
+
+        jobAvailable.notify_all();
+
+        for (std::thread &worker: workers)
+            worker.join();
+
+        workers.clear();
+    }
+
+    void AssetLoader::enqueue(const std::shared_ptr<Job> &job)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (stopping)
+                return;
+
+            requested++;
+
+            // nothing to decode, straight to the main thread
+            if (!job->decode)
+            {
+                finishQueue.push_back(job);
+                return;
+            }
+
+            decodeQueue.push_back(job);
+        }
+
+        if (workers.empty())
+        {
+            // leave a core for the main thread
+            int count = std::max(1, std::min(4, SDL_GetCPUCount() - 1));
+            for (int i = 0; i < count; i++)
+                workers.emplace_back(&AssetLoader::runWorker, this);
+        }
+
+        jobAvailable.notify_one();
+    }
+
+    void AssetLoader::runWorker()
+    {
+#ifdef FRUITWORK_PROFILING
+        Profiler::getInstance()->setThreadName("Asset loader");
+#endif
+
+        while (true)
+        {
+            std::shared_ptr<Job> job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                jobAvailable.wait(lock, [this]() { return stopping || !decodeQueue.empty(); });
+
+                if (stopping)
+                    return;
+
+                job = decodeQueue.front();
+                decodeQueue.pop_front();
+            }
+
+            job->decode();
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!stopping)
+                finishQueue.push_back(job);
+        }
+    }
+
+    template<typename T>
+    void AssetLoader::complete(Pending<T> &pending, T value)
+    {
+        pending.value = std::move(value);
+        pending.ready = true;
+        finished++;
+
+        if (pending.onLoaded)
+        {
+            pending.onLoaded(pending.value);
+            pending.onLoaded = nullptr;
+        }
+    }
+
+} // fruitwork
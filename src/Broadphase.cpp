@@ -0,0 +1,95 @@
+#include "Broadphase.h"
+#include "Component.h"
+
+namespace fruitwork
+{
+    Broadphase::Broadphase(int cellSize) : cellSize(cellSize) {}
+
+    void Broadphase::setCellSize(int size)
+    {
+        if (size <= 0)
+        {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Invalid broadphase cell size: %d", size);
+            return;
+        }
+
+        cellSize = size;
+        cells.clear(); // keys depend on the cell size
+        occupiedCells.clear();
+    }
+
+    int Broadphase::cellCoordinate(int position) const
+    {
+        // floor division, so negative positions don't share cell 0 with positive ones
+        return position >= 0 ? position / cellSize : (position - cellSize + 1) / cellSize;
+    }
+
+    void Broadphase::rebuild(const ComponentView &components)
+    {
+        for (Sint64 key: occupiedCells)
+            cells[key].clear();
+
+        occupiedCells.clear();
+        bodies.clear();
+
+        for (Component *component: components)
+        {
+            PhysicsBody *body = component->getPhysicsBody();
+            if (body == nullptr || !body->getObjCollision())
+                continue;
+
+            const SDL_Rect &rect = body->getRect();
+            int index = (int) bodies.size();
+            bodies.push_back(body);
+
+            int minX = cellCoordinate(rect.x);
+            int minY = cellCoordinate(rect.y);
+            int maxX = cellCoordinate(rect.x + rect.w - 1);
+            int maxY = cellCoordinate(rect.y + rect.h - 1);
+
+            for (int cx = minX; cx <= maxX; cx++)
+            {
+                for (int cy = minY; cy <= maxY; cy++)
+                {
+                    std::vector<int> &cell = cells[cellKey(cx, cy)];
+                    if (cell.empty())
+                        occupiedCells.push_back(cellKey(cx, cy));
+
+                    cell.push_back(index);
+                }
+            }
+        }
+    }
+
+    const std::vector<Broadphase::Pair> &Broadphase::findPairs()
+    {
+        pairs.clear();
+
+        for (Sint64 key: occupiedCells)
+        {
+            const std::vector<int> &cell = cells[key];
+
+            for (int i = 0; i < cell.size(); i++)
+            {
+                for (int j = i + 1; j < cell.size(); j++)
+                {
+                    PhysicsBody *a = bodies[cell[i]];
+                    PhysicsBody *b = bodies[cell[j]];
+
+                    SDL_Rect overlap;
+                    if (!SDL_IntersectRect(&a->getRect(), &b->getRect(), &overlap))
+                        continue;
+
+                    // two bodies can share many cells, only report the pair from the cell holding the top left of their overlap
+                    if (cellKey(cellCoordinate(overlap.x), cellCoordinate(overlap.y)) != key)
+                        continue;
+
+                    pairs.push_back({a, b});
+                }
+            }
+        }
+
+        return pairs;
+    }
+
+} // fruitwork
@@ -1,30 +1,22 @@
 #include "Button.h"
 #include "System.h"
-#include "SDL_image.h"
 #include "Constants.h"
 #include "Component.h"
 #include "ResourceManager.h"
+#include "RenderQueue.h"
 
 namespace fruitwork
 {
     Button::Button(int x, int y, int w, int h, std::string text) : Component(x, y, w, h), text(text)
     {
-        SDL_Surface *surf = TTF_RenderText_Blended(fruitwork::sys.getFont(), text.c_str(), textColor);
-        textTexture = SDL_CreateTextureFromSurface(fruitwork::sys.getRenderer(), surf);
-        SDL_FreeSurface(surf);
+        GlyphAtlas::getInstance(sys.getFont())->layout(text, textLayout);
 
-        // todo: only load textures if they are not already loaded?
-        buttonTextureLeft = IMG_LoadTexture(fruitwork::sys.getRenderer(), ResourceManager::getTexturePath("button-left.png").c_str());
-        buttonTextureMiddle = IMG_LoadTexture(fruitwork::sys.getRenderer(), ResourceManager::getTexturePath("button-middle.png").c_str());
-        buttonTextureRight = IMG_LoadTexture(fruitwork::sys.getRenderer(), ResourceManager::getTexturePath("button-right.png").c_str());
+        buttonTextureLeft = ResourceManager::getTexture(ResourceManager::getTexturePath("button-left.png"));
+        buttonTextureMiddle = ResourceManager::getTexture(ResourceManager::getTexturePath("button-middle.png"));
+        buttonTextureRight = ResourceManager::getTexture(ResourceManager::getTexturePath("button-right.png"));
 
-        clickSound = Mix_LoadWAV(ResourceManager::getAudioPath("click.wav").c_str());
-        hoverSound = Mix_LoadWAV(ResourceManager::getAudioPath("hover.wav").c_str());
-
-        if (font == nullptr)
-        {
-            font = TTF_OpenFont(constants::gDefaultFontPath.c_str(), 64);
-        }
+        clickSound = ResourceManager::getSound(ResourceManager::getAudioPath("click.wav"));
+        hoverSound = ResourceManager::getSound(ResourceManager::getAudioPath("hover.wav"));
     }
 
     Button *Button::getInstance(int x, int y, int w, int h, std::string txt)
@@ -36,14 +28,14 @@ namespace fruitwork
     {
         SDL_Rect rect = getAbsoluteRect();
 
+        SDL_Color color = {buttonColor.r, buttonColor.g, buttonColor.b, 255};
+
         switch (state)
         {
             case Button::State::PRESSED:
             {
                 const double mod = 0.8;
-                SDL_SetTextureColorMod(buttonTextureLeft, buttonColor.r * mod, buttonColor.g * mod, buttonColor.b * mod);
-                SDL_SetTextureColorMod(buttonTextureMiddle, buttonColor.r * mod, buttonColor.g * mod, buttonColor.b * mod);
-                SDL_SetTextureColorMod(buttonTextureRight, buttonColor.r * mod, buttonColor.g * mod, buttonColor.b * mod);
+                color = {static_cast<Uint8>(buttonColor.r * mod), static_cast<Uint8>(buttonColor.g * mod), static_cast<Uint8>(buttonColor.b * mod), 255};
 
                 rect.x += 2;
                 rect.y += 2;
@@ -54,39 +46,31 @@ namespace fruitwork
             case Button::State::HOVER:
             {
                 const double mod = 0.95;
-                SDL_SetTextureColorMod(buttonTextureLeft, buttonColor.r * mod, buttonColor.g * mod, buttonColor.b * mod);
-                SDL_SetTextureColorMod(buttonTextureMiddle, buttonColor.r * mod, buttonColor.g * mod, buttonColor.b * mod);
-                SDL_SetTextureColorMod(buttonTextureRight, buttonColor.r * mod, buttonColor.g * mod, buttonColor.b * mod);
+                color = {static_cast<Uint8>(buttonColor.r * mod), static_cast<Uint8>(buttonColor.g * mod), static_cast<Uint8>(buttonColor.b * mod), 255};
                 break;
             }
 
             case Button::State::NORMAL:
-            {
-                SDL_SetTextureColorMod(buttonTextureLeft, buttonColor.r, buttonColor.g, buttonColor.b);
-                SDL_SetTextureColorMod(buttonTextureMiddle, buttonColor.r, buttonColor.g, buttonColor.b);
-                SDL_SetTextureColorMod(buttonTextureRight, buttonColor.r, buttonColor.g, buttonColor.b);
                 break;
-            }
         }
 
         SDL_Rect leftRect = {rect.x, rect.y, 8, rect.h};
         SDL_Rect middleRect = {rect.x + 8, rect.y, rect.w - 16, rect.h};
         SDL_Rect rightRect = {rect.x + rect.w - 8, rect.y, 8, rect.h};
 
-        SDL_RenderCopy(sys.getRenderer(), buttonTextureLeft, nullptr, &leftRect);
-        SDL_RenderCopy(sys.getRenderer(), buttonTextureMiddle, nullptr, &middleRect);
-        SDL_RenderCopy(sys.getRenderer(), buttonTextureRight, nullptr, &rightRect);
+        RenderQueue *queue = RenderQueue::getInstance();
+        queue->submit(buttonTextureLeft.get(), nullptr, leftRect, 0, nullptr, SDL_FLIP_NONE, color);
+        queue->submit(buttonTextureMiddle.get(), nullptr, middleRect, 0, nullptr, SDL_FLIP_NONE, color);
+        queue->submit(buttonTextureRight.get(), nullptr, rightRect, 0, nullptr, SDL_FLIP_NONE, color);
 
         // the text should be centered, and have a 10% margin on all sides
         SDL_Rect textRect = {rect.x + 10, rect.y + 10, rect.w - 20, rect.h - 20};
-        int w, h;
-        SDL_QueryTexture(textTexture, nullptr, nullptr, &w, &h);
-        textRect.w = w;
-        textRect.h = h;
+        textRect.w = textLayout.width;
+        textRect.h = textLayout.height;
         // center text in button
-        textRect.x += (rect.w - 20 - w) / 2;
-        textRect.y += (rect.h - 20 - h) / 2;
-        SDL_RenderCopy(sys.getRenderer(), textTexture, nullptr, &textRect);
+        textRect.x += (rect.w - 20 - textRect.w) / 2;
+        textRect.y += (rect.h - 20 - textRect.h) / 2;
+        textLayout.draw({textRect.x, textRect.y}, textColor);
     }
 
     void Button::update()
@@ -105,13 +89,6 @@ namespace fruitwork
 
     Button::~Button()
     {
-        SDL_DestroyTexture(textTexture);
-        SDL_DestroyTexture(buttonTextureLeft);
-        SDL_DestroyTexture(buttonTextureMiddle);
-        SDL_DestroyTexture(buttonTextureRight);
-        Mix_FreeChunk(clickSound);
-        Mix_FreeChunk(hoverSound);
-
         SDL_SetCursor(sys.getCursorDefault()); // reset cursor
     }
 
@@ -145,11 +122,8 @@ namespace fruitwork
 
     void Button::setTextColor(const SDL_Color &color)
     {
+        // the color is applied when drawing
         textColor = color;
-        SDL_DestroyTexture(textTexture);
-        SDL_Surface *surf = TTF_RenderText_Blended(sys.getFont(), text.c_str(), textColor);
-        textTexture = SDL_CreateTextureFromSurface(sys.getRenderer(), surf);
-        SDL_FreeSurface(surf);
     }
 
     void Button::setColor(const SDL_Color &color)
@@ -167,7 +141,7 @@ namespace fruitwork
             case State::HOVER:
             {
                 if (state == State::NORMAL)
-                    Mix_PlayChannel(-1, hoverSound, 0);
+                    Mix_PlayChannel(-1, hoverSound.get(), 0);
 
                 SDL_SetCursor(sys.getCursorPointer());
                 break;
@@ -175,7 +149,7 @@ namespace fruitwork
             case State::PRESSED:
             {
                 SDL_SetCursor(sys.getCursorPointer());
-                Mix_PlayChannel(-1, clickSound, 0);
+                Mix_PlayChannel(-1, clickSound.get(), 0);
                 break;
             }
             case State::NORMAL:
@@ -188,6 +162,4 @@ namespace fruitwork
         state = s;
     }
 
-    TTF_Font *Button::font = nullptr;
-
 } // fruitwork
\ No newline at end of file
@@ -1,5 +1,6 @@
+#include <cmath>
+#include <algorithm>
 #include "Circle.h"
-#include "System.h"
 
 namespace fruitwork
 {
@@ -9,37 +10,27 @@ namespace fruitwork
         return new Circle(x, y, r, c);
     }
 
-    fruitwork::Circle::Circle(int x, int y, int r, SDL_Color c) : Shape(x, y, r, r, c), radius(r)
+    fruitwork::Circle::Circle(int x, int y, int r, SDL_Color c) : Shape(x, y, r * 2, r * 2, c) {}
+
+    void Circle::setRadius(int r)
     {
-        // x is the top left corner, centerX is the center of the circle
-        this->centerX = x + r;
-        this->centerY = y + r;
+        SDL_Rect rect = getRect();
+        setRect({rect.x, rect.y, r * 2, r * 2});
     }
 
-    void fruitwork::Circle::draw() const
+    void Circle::buildOutline(int w, int h, std::vector<SDL_FPoint> &outline) const
     {
-        SDL_SetRenderDrawColor(sys.getRenderer(), color.r, color.g, color.b, color.a);
-        SDL_SetRenderDrawBlendMode(sys.getRenderer(), SDL_BLENDMODE_BLEND); // respect alpha
+        float radiusX = (float) w / 2, radiusY = (float) h / 2;
 
-        // draw circle
-        // @see https://stackoverflow.com/a/24453110/11420970
-        int r2 = radius * radius;
-        int area = r2 << 2;
-        int rr = radius << 1;
+        // more segments for bigger circles, about one every 4 pixels of the circumference up to a limit
+        int segments = std::max(12, std::min(256, (int) (M_PI * (radiusX + radiusY) / 4)));
 
-        for (int i = 0; i < area; i++)
+        // clockwise, since y points down
+        for (int i = 0; i < segments; i++)
         {
-            int tx = i % rr - radius;
-            int ty = i / rr - radius;
-            if (tx * tx + ty * ty <= r2)
-            {
-                SDL_RenderDrawPoint(sys.getRenderer(), centerX + tx, centerY + ty);
-            }
+            double angle = 2 * M_PI * i / segments;
+            outline.push_back({radiusX + radiusX * (float) std::cos(angle), radiusY + radiusY * (float) std::sin(angle)});
         }
-
-        // reset
-        SDL_SetRenderDrawColor(sys.getRenderer(), 255, 255, 255, 255);
-        SDL_SetRenderDrawBlendMode(sys.getRenderer(), SDL_BLENDMODE_NONE);
     }
 
-} // fruitwork
\ No newline at end of file
+} // fruitwork
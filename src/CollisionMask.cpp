@@ -0,0 +1,135 @@
+#include <algorithm>
+#include "CollisionMask.h"
+#include "ResourceManager.h"
+#include "Profiler.h"
+
+namespace fruitwork
+{
+    std::unordered_map<std::string, std::weak_ptr<const CollisionMask>> CollisionMask::masks;
+
+    CollisionMask::CollisionMask(int w, int h, Uint8 alpha) : w(std::max(0, w)), h(std::max(0, h)), alpha(alpha)
+    {
+        wordsPerRow = (this->w + 63) / 64 + 1;
+        bits.assign((size_t) wordsPerRow * this->h, 0);
+    }
+
+    CollisionMask::Handle CollisionMask::getInstance(const std::string &path, Uint8 alpha)
+    {
+        std::string key = path + ":" + std::to_string(alpha);
+
+        auto cached = masks.find(key);
+        Handle mask = cached != masks.end() ? cached->second.lock() : nullptr;
+        if (mask != nullptr)
+            return mask;
+
+        FRUITWORK_PROFILE_ZONE("CollisionMask: build mask");
+
+        ResourceManager::SurfaceHandle surface = ResourceManager::getSurface(path);
+        if (surface == nullptr)
+            return nullptr;
+
+        // read the alpha from one known format, whatever the image was decoded to
+        SDL_Surface *converted = SDL_ConvertSurfaceFormat(surface.get(), SDL_PIXELFORMAT_ARGB8888, 0);
+        if (converted == nullptr)
+        {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to convert %s for its collision mask: %s", path.c_str(), SDL_GetError());
+            return nullptr;
+        }
+
+        auto built = std::make_shared<CollisionMask>(converted->w, converted->h, alpha);
+
+        SDL_LockSurface(converted);
+        for (int y = 0; y < converted->h; y++)
+        {
+            auto *row = (const Uint32 *) ((const Uint8 *) converted->pixels + y * converted->pitch);
+            Uint64 *rowBits = built->bits.data() + (size_t) y * built->wordsPerRow;
+
+            for (int x = 0; x < converted->w; x++)
+            {
+                if ((row[x] >> 24) > alpha)
+                    rowBits[x / 64] |= Uint64(1) << (x % 64);
+            }
+        }
+        SDL_UnlockSurface(converted);
+        SDL_FreeSurface(converted);
+
+        // only cached once built, so images that failed to load don't leave entries behind
+        masks[key] = built;
+        return built;
+    }
+
+    void CollisionMask::releaseUnused()
+    {
+        for (auto it = masks.begin(); it != masks.end();)
+        {
+            if (it->second.expired())
+                it = masks.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    CollisionMask::Handle CollisionMask::scaled(int scaledWidth, int scaledHeight) const
+    {
+        if (scaledWidth == w && scaledHeight == h)
+            return std::make_shared<CollisionMask>(*this);
+
+        FRUITWORK_PROFILE_ZONE("CollisionMask::scaled");
+
+        auto mask = std::make_shared<CollisionMask>(scaledWidth, scaledHeight, alpha);
+        if (w == 0 || h == 0)
+            return mask;
+
+        // the source column of every scaled column, the same for every row
+        std::vector<int> columns(mask->w);
+        for (int x = 0; x < mask->w; x++)
+            columns[x] = (int) ((Sint64) x * w / mask->w);
+
+        for (int y = 0; y < mask->h; y++)
+        {
+            int sourceY = (int) ((Sint64) y * h / mask->h);
+            Uint64 *rowBits = mask->bits.data() + (size_t) y * mask->wordsPerRow;
+
+            for (int x = 0; x < mask->w; x++)
+            {
+                if (isOpaque(columns[x], sourceY))
+                    rowBits[x / 64] |= Uint64(1) << (x % 64);
+            }
+        }
+
+        return mask;
+    }
+
+    Uint64 CollisionMask::getBits(int y, int x) const
+    {
+        const Uint64 *word = bits.data() + (size_t) y * wordsPerRow + x / 64;
+        int shift = x % 64;
+
+        // the padding word at the end of the row keeps word[1] in bounds
+        if (shift == 0)
+            return word[0];
+
+        return (word[0] >> shift) | (word[1] << (64 - shift));
+    }
+
+    bool CollisionMask::overlaps(const CollisionMask &a, SDL_Point aPosition, const CollisionMask &b, SDL_Point bPosition)
+    {
+        int left = std::max(aPosition.x, bPosition.x);
+        int right = std::min(aPosition.x + a.w, bPosition.x + b.w);
+        int top = std::max(aPosition.y, bPosition.y);
+        int bottom = std::min(aPosition.y + a.h, bPosition.y + b.h);
+
+        // the mask ending at the right of the intersection has no bits past it, so the last word needs no masking
+        for (int y = top; y < bottom; y++)
+        {
+            for (int x = left; x < right; x += 64)
+            {
+                if (a.getBits(y - aPosition.y, x - aPosition.x) & b.getBits(y - bPosition.y, x - bPosition.x))
+                    return true;
+            }
+        }
+
+        return false;
+    }
+
+} // fruitwork
@@ -1,4 +1,5 @@
 #include <stdexcept>
+#include <algorithm>
 #include "Component.h"
 #include "System.h"
 
@@ -14,6 +15,37 @@ namespace fruitwork
         delete body;
     }
 
+    Uint32 Component::zIndexGeneration = 0;
+
+    void Component::insertByZIndex(std::vector<Component *> &list, Component *component)
+    {
+        // upper_bound finds the first component with a higher z-index, so equal z-indices keep their insertion order
+        auto it = std::upper_bound(list.begin(), list.end(), component, [](const Component *a, const Component *b)
+        {
+            return a->zIndex() < b->zIndex();
+        });
+
+        list.insert(it, component);
+    }
+
+    void Component::sortByZIndex(std::vector<Component *> &list)
+    {
+        // insertion sort, the list is almost always sorted already
+        for (int i = 1; i < list.size(); i++)
+        {
+            Component *component = list[i];
+            int j = i;
+
+            while (j > 0 && list[j - 1]->zIndex() > component->zIndex())
+            {
+                list[j] = list[j - 1];
+                j--;
+            }
+
+            list[j] = component;
+        }
+    }
+
     void Component::addChild(Component *child)
     {
         // remove child from old parent
@@ -23,6 +55,7 @@ namespace fruitwork
         // add child to this component
         children.push_back(child);
         child->parent = this;
+        child->invalidateTransform();
     }
 
     void Component::removeChild(Component *child)
@@ -33,6 +66,7 @@ namespace fruitwork
             {
                 children.erase(it);
                 child->parent = nullptr;
+                child->invalidateTransform();
 
                 return;
             }
@@ -48,7 +82,35 @@ namespace fruitwork
         }
     }
 
+    void Component::interpolate(float alpha)
+    {
+        if (body != nullptr)
+            setRect(body->getInterpolatedRect(alpha));
+    }
+
+    void Component::invalidateTransform()
+    {
+        // a dirty component only has dirty descendants, no need to go further
+        if (transformDirty)
+            return;
+
+        transformDirty = true;
+        for (Component *child: children)
+            child->invalidateTransform();
+    }
+
     const SDL_Rect &Component::getAbsoluteRect() const
+    {
+        if (!transformDirty && transformGeneration == sys.getLayoutGeneration())
+            return absoluteRect;
+
+        absoluteRect = calculateAbsoluteRect();
+        transformDirty = false;
+        transformGeneration = sys.getLayoutGeneration();
+        return absoluteRect;
+    }
+
+    SDL_Rect Component::calculateAbsoluteRect() const
     {
         SDL_Rect localRect = getRect();
         SDL_Rect parentAbsoluteRect = getParentAbsoluteRect();
@@ -64,8 +126,7 @@ namespace fruitwork
             newAbsoluteRect.y = parentAbsoluteRect.y + localRect.y;
             newAbsoluteRect.w = localRect.w;
             newAbsoluteRect.h = localRect.h;
-            absoluteRect = newAbsoluteRect;
-            return absoluteRect;
+            return newAbsoluteRect;
         }
 
         // Non-legacy, x/width
@@ -92,8 +153,7 @@ namespace fruitwork
             newAbsoluteRect.h = sizeDelta.y;
         }
 
-        absoluteRect = newAbsoluteRect;
-        return absoluteRect;
+        return newAbsoluteRect;
     }
 
     SDL_Rect Component::getParentAbsoluteRect() const
@@ -101,8 +161,8 @@ namespace fruitwork
         SDL_Rect parentAbsoluteRect; // if no component parent, we use the window size
         if (parent == nullptr)
         {
-            SDL_Window *window = sys.getWindow();
-            SDL_GetWindowSize(window, &parentAbsoluteRect.w, &parentAbsoluteRect.h);
+            parentAbsoluteRect.w = sys.getWindowSize().x;
+            parentAbsoluteRect.h = sys.getWindowSize().y;
             parentAbsoluteRect.x = 0;
             parentAbsoluteRect.y = 0;
         }
@@ -115,7 +175,8 @@ namespace fruitwork
 
     SDL_Point Component::getPixelPivot() const
     {
-        SDL_Point pivot = {(int)(absoluteRect.w * normalizedPivot.x), (int)(absoluteRect.h * normalizedPivot.y)};
+        const SDL_Rect &r = getAbsoluteRect();
+        SDL_Point pivot = {(int)(r.w * normalizedPivot.x), (int)(r.h * normalizedPivot.y)};
         return pivot;
     }
 
@@ -132,6 +193,7 @@ namespace fruitwork
         anchorMin = newAnchorMin;
         anchorMax = newAnchorMax;
         anchorPreset = Anchor::CUSTOM;
+        invalidateTransform();
     }
 
     void Component::setAnchorAndPivot(Anchor newAnchor)
@@ -143,6 +205,7 @@ namespace fruitwork
     void Component::setAnchor(Anchor newAnchor)
     {
         anchorPreset = newAnchor;
+        invalidateTransform();
 
         switch (newAnchor)
         {
@@ -218,6 +281,8 @@ namespace fruitwork
 
     void Component::setPivot(Anchor newAnchor)
     {
+        invalidateTransform();
+
         switch (newAnchor)
         {
             case Anchor::TOP_LEFT:
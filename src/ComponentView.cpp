@@ -0,0 +1,25 @@
+#include "ComponentView.h"
+#include "Scene.h"
+
+namespace fruitwork
+{
+    ComponentView::ComponentView(const std::vector<Component *> &components, Scene *owner)
+            : first(components.data()), last(components.data() + components.size()), owner(owner)
+    {
+        if (owner != nullptr)
+            owner->beginIteration();
+    }
+
+    ComponentView::ComponentView(const ComponentView &other) : first(other.first), last(other.last), owner(other.owner)
+    {
+        if (owner != nullptr)
+            owner->beginIteration();
+    }
+
+    ComponentView::~ComponentView()
+    {
+        if (owner != nullptr)
+            owner->endIteration();
+    }
+
+} // fruitwork
@@ -1,104 +1,97 @@
-#include <random>
 #include <algorithm>
-#include <SDL_image.h>
-#include <thread>
 #include "ConfettiCannon.h"
-#include "Constants.h"
-#include "System.h"
 
 namespace fruitwork
 {
+    /** How long a confetti lives if it doesn't fade out, in milliseconds. */
+    static const int CONFETTI_LIFETIME = 7000;
+
+    /** How long a confetti flies before it starts fading out, in milliseconds. */
+    static const int FADE_OUT_DELAY = 200;
+
+    /** The most fade out times a cannon keeps an emitter for. */
+    static const int MAX_FADES = 4;
+
     ConfettiCannon *fruitwork::ConfettiCannon::getInstance(int x, int y, int w, int h, const std::string &texturePath)
     {
         return new ConfettiCannon(x, y, w, h, texturePath);
     }
 
-    void fruitwork::ConfettiCannon::draw() const
+    ConfettiCannon::ConfettiCannon(int x, int y, int w, int h, const std::string &texturePath)
+            : ParticleSystem(x, y, w, h, texturePath)
     {
-        for (auto &c : confetti)
-        {
-            if (c == nullptr || !c->started)
-                continue;
-
-            c->sprite->draw();
-        }
+        // what a physics body with a gravity scale of 2 and the default friction does to a launched confetti
+        setGravity(196);
+        setDrag(0.095f);
     }
 
-    void fruitwork::ConfettiCannon::update(float elapsedTime)
+    void ConfettiCannon::fire(float angle, int spread, int amount, int time, int fadeOutTime)
     {
-        for (auto &c : confetti)
-        {
-            if (c == nullptr) // not optimal but to prevent segfaults
-                continue;
+        int emitter = getFadeEmitter(fadeOutTime);
 
-            // start if not started & time has passed
-            if (!c->started)
-            {
-                if (SDL_GetTicks64() >= c->startTime)
-                {
-                    c->started = true;
-                    c->sprite->getPhysicsBody()->addForce(c->force.x, c->force.y);
-                    if (c->fadeOutTime != -1)
-                        c->sprite->fadeOut(c->fadeOutTime, 200);
-                }
-                else
-                {
-                    continue;
-                }
-            }
+        // the cannon only ever tinted its confetti, the alpha of the colors is not used
+        std::vector<SDL_Color> &emitterColors = getEmitter(emitter).colors;
+        emitterColors = colors;
+        for (SDL_Color &color: emitterColors)
+            color.a = 255;
 
-            c->sprite->update(elapsedTime);
+        burst(emitter, amount, time / 1000.0f, angle, (float) spread);
+    }
 
-            if (c->startTime + 7000 < SDL_GetTicks64())
+    int ConfettiCannon::getFadeEmitter(int fadeOutTime)
+    {
+        shotCount++;
+
+        for (Fade &fade: fades)
+        {
+            if (fade.fadeOutTime == fadeOutTime)
             {
-                delete c->sprite;
-                c = nullptr;
+                fade.lastShot = shotCount;
+                return fade.emitter;
             }
         }
-    }
 
-    ConfettiCannon::ConfettiCannon(int x, int y, int w, int h, const std::string &texturePath) : Component(x, y, w, h)
-    {
-        texture = IMG_LoadTexture(sys.getRenderer(), texturePath.c_str());
-    }
+        Fade *fade;
+        if (fades.size() < MAX_FADES)
+        {
+            SDL_Rect r = getRect();
 
-    void ConfettiCannon::fire(float angle, int spread, int amount, int time, int fadeOutTime)
-    {
-        for (int i = 0; i < amount; i++)
+            Emitter emitter;
+            emitter.position = {r.w / 2.0f, r.h / 2.0f};
+            emitter.size = {r.w, r.h};
+            emitter.minSpeed = emitter.maxSpeed = 1000;
+            emitter.speedScale = {1, 2};
+            emitter.maxRotation = 360;
+
+            fades.push_back({fadeOutTime, addEmitter(emitter), shotCount});
+            fade = &fades.back();
+        }
+        else
         {
-            std::random_device rd;
-            std::mt19937 g(rd());
-            std::uniform_int_distribution<int> dist(0, colors.size() - 1);
-            SDL_Color c = colors[dist(g)];
+            // take one without confetti in flight, or else the one fired the longest ago, its confetti fades out like the new shot
+            fade = &*std::min_element(fades.begin(), fades.end(), [this](const Fade &a, const Fade &b)
+            {
+                bool aIdle = getParticleCount(a.emitter) == 0, bIdle = getParticleCount(b.emitter) == 0;
+                return aIdle != bIdle ? aIdle : a.lastShot < b.lastShot;
+            });
 
-            SDL_Rect r = getRect();
-            PhysicsBody *b = PhysicsBody::getInstance(r);
-            b->setGravity(2);
-
-            auto *conf = new Confetti();
-            conf->sprite = Sprite::getInstance(r.x, r.y, r.w, r.h, texture);
-            conf->sprite->setPhysicsBody(b);
-            conf->sprite->setColorMod(c);
-            conf->sprite->setAngle(rand() % 360 * -1);
-            conf->startTime = SDL_GetTicks64() + (time / amount) * i;
-            conf->fadeOutTime = fadeOutTime;
-
-            // add force towards the angle with a random spread
-            float iAngle = angle - spread / 2.0f + rand() % spread;
-            float forceX = cosf(iAngle * M_PI / 180) * 1000;
-            float forceY = sinf(iAngle * M_PI / 180) * 2000;
-            conf->force = {forceX, forceY};
-
-            confetti.push_back(conf);
+            fade->fadeOutTime = fadeOutTime;
+            fade->lastShot = shotCount;
         }
-    }
 
-    ConfettiCannon::~ConfettiCannon()
-    {
-        for (auto &c : confetti)
-            delete c;
+        Emitter &emitter = getEmitter(fade->emitter);
+        emitter.minLifetime = emitter.maxLifetime = CONFETTI_LIFETIME / 1000.0f;
+        emitter.alpha = Curve();
+
+        if (fadeOutTime != -1)
+        {
+            // dead once faded out
+            float lifetime = (float) (FADE_OUT_DELAY + fadeOutTime);
+            emitter.minLifetime = emitter.maxLifetime = lifetime / 1000;
+            emitter.alpha = {1, 0, FADE_OUT_DELAY / lifetime, 1};
+        }
 
-        SDL_DestroyTexture(texture);
+        return fade->emitter;
     }
 
-} // fruitwork
\ No newline at end of file
+} // fruitwork
@@ -12,12 +12,25 @@ namespace fruitwork
         return new CoveringSprite(x, y, w, h, texture);
     }
 
+    CoveringSprite *CoveringSprite::getInstance(int x, int y, int w, int h, const TextureAtlas::Region &region)
+    {
+        return new CoveringSprite(x, y, w, h, region);
+    }
+
+    CoveringSprite *CoveringSprite::getAtlasInstance(int x, int y, int w, int h, const std::string &imageName)
+    {
+        return new CoveringSprite(x, y, w, h, TextureAtlas::getImage(imageName));
+    }
+
     CoveringSprite::CoveringSprite(int x, int y, int w, int h, const std::string &texturePath) :
             Sprite(x, y, w, h, texturePath), originalRect({x, y, w, h}) {}
 
     CoveringSprite::CoveringSprite(int x, int y, int w, int h, SDL_Texture *texture) :
             Sprite(x, y, w, h, texture), originalRect({x, y, w, h}) {}
 
+    CoveringSprite::CoveringSprite(int x, int y, int w, int h, const TextureAtlas::Region &region) :
+            Sprite(x, y, w, h, region), originalRect({x, y, w, h}) {}
+
     void CoveringSprite::start()
     {
         updateRect();
@@ -35,14 +48,20 @@ namespace fruitwork
         updateRect();
     }
 
+    void CoveringSprite::setRegion(const TextureAtlas::Region &region)
+    {
+        Sprite::setRegion(region);
+        updateRect();
+    }
+
 #pragma clang diagnostic push
 #pragma ide diagnostic ignored "cppcoreguidelines-narrowing-conversions"
 
     void CoveringSprite::updateRect()
     {
         SDL_Rect original = originalRect;
-        int w, h;
-        SDL_QueryTexture(this->spriteTexture, nullptr, nullptr, &w, &h);
+        SDL_Point size = getImageSize();
+        int w = size.x, h = size.y;
 
         float scale = std::max((float) original.w / w, (float) original.h / h);
 
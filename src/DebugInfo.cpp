@@ -28,7 +28,7 @@ namespace fruitwork
         cachedText.clear();
         cachedText.reserve(4096);
 
-        const auto &components = scene->getComponents();
+        ComponentView components = scene->getComponents();
         for (const Component *comp : components)
             collectDebugInfo(cachedText, comp, 0);
 
@@ -0,0 +1,98 @@
+#include <algorithm>
+#include <cstring>
+#include "GapBuffer.h"
+
+namespace fruitwork
+{
+    GapBuffer::GapBuffer(size_t capacity) : buffer(capacity), gapEnd(capacity) {}
+
+    void GapBuffer::insert(size_t position, const char *text, size_t length)
+    {
+        position = std::min(position, size());
+
+        if (gapEnd - gapStart < length)
+            grow(length);
+
+        moveGap(position);
+        std::memcpy(buffer.data() + gapStart, text, length);
+        gapStart += length;
+    }
+
+    void GapBuffer::erase(size_t position, size_t length)
+    {
+        if (position >= size())
+            return;
+
+        length = std::min(length, size() - position);
+
+        // the erased text becomes part of the gap
+        moveGap(position);
+        gapEnd += length;
+    }
+
+    void GapBuffer::clear()
+    {
+        gapStart = 0;
+        gapEnd = buffer.size();
+    }
+
+    void GapBuffer::copy(size_t position, size_t length, std::string &out) const
+    {
+        out.clear();
+
+        position = std::min(position, size());
+        length = std::min(length, size() - position);
+        size_t end = position + length;
+
+        // the part before the gap, then the part after it
+        if (position < gapStart)
+            out.append(buffer.data() + position, std::min(end, gapStart) - position);
+
+        if (end > gapStart)
+        {
+            size_t from = std::max(position, gapStart);
+            out.append(buffer.data() + from + (gapEnd - gapStart), end - from);
+        }
+    }
+
+    std::string GapBuffer::toString() const
+    {
+        std::string text;
+        copy(0, size(), text);
+        return text;
+    }
+
+    void GapBuffer::moveGap(size_t position)
+    {
+        if (position < gapStart)
+        {
+            // move the text between the position and the gap behind the gap
+            size_t length = gapStart - position;
+            std::memmove(buffer.data() + gapEnd - length, buffer.data() + position, length);
+            gapStart -= length;
+            gapEnd -= length;
+        }
+        else if (position > gapStart)
+        {
+            // move the text between the gap and the position in front of the gap
+            size_t length = position - gapStart;
+            std::memmove(buffer.data() + gapStart, buffer.data() + gapEnd, length);
+            gapStart += length;
+            gapEnd += length;
+        }
+    }
+
+    void GapBuffer::grow(size_t length)
+    {
+        size_t afterGap = buffer.size() - gapEnd;
+        size_t capacity = std::max(buffer.size() * 2, size() + length);
+
+        std::vector<char> grown(capacity);
+        std::memcpy(grown.data(), buffer.data(), gapStart);
+        std::memcpy(grown.data() + capacity - afterGap, buffer.data() + gapEnd, afterGap);
+
+        buffer.swap(grown);
+        gapEnd = capacity - afterGap;
+    }
+
+} // fruitwork
@@ -0,0 +1,284 @@
+#include <cmath>
+#include <algorithm>
+#include "GlyphAtlas.h"
+#include "System.h"
+#include "RenderQueue.h"
+#include "Profiler.h"
+
+namespace fruitwork
+{
+    /** Empty pixels between glyphs, so scaled text doesn't bleed into its neighbours. */
+    static const int GLYPH_PADDING = 1;
+
+    /** The atlases by font. Never destroyed, System releases its font after other statics may be gone. */
+    static std::unordered_map<TTF_Font *, GlyphAtlas *> &getAtlases()
+    {
+        static auto *atlases = new std::unordered_map<TTF_Font *, GlyphAtlas *>();
+        return *atlases;
+    }
+
+    Uint32 GlyphAtlas::decodeUtf8(const std::string &text, size_t &index)
+    {
+        auto byte = (unsigned char) text[index++];
+
+        if (byte < 0x80)
+            return byte;
+
+        int length = byte >= 0xF0 ? 3 : byte >= 0xE0 ? 2 : byte >= 0xC0 ? 1 : -1;
+        if (length < 0)
+            return 0xFFFD;
+
+        Uint32 codepoint = byte & (0x3F >> length);
+        for (int i = 0; i < length; i++)
+        {
+            if (index >= text.size() || (text[index] & 0xC0) != 0x80)
+                return 0xFFFD;
+
+            codepoint = (codepoint << 6) | (text[index++] & 0x3F);
+        }
+
+        return codepoint;
+    }
+
+    GlyphAtlas *GlyphAtlas::getInstance(TTF_Font *font)
+    {
+        GlyphAtlas *&atlas = getAtlases()[font];
+        if (atlas == nullptr)
+            atlas = new GlyphAtlas(font);
+
+        return atlas;
+    }
+
+    void GlyphAtlas::release(TTF_Font *font)
+    {
+        auto it = getAtlases().find(font);
+        if (it == getAtlases().end())
+            return;
+
+        delete it->second;
+        getAtlases().erase(it);
+    }
+
+    GlyphAtlas::GlyphAtlas(TTF_Font *font) : font(font)
+    {
+        kerning = font != nullptr && TTF_GetFontKerning(font) != 0;
+        lineSkip = font != nullptr ? TTF_FontLineSkip(font) : 0;
+        fontHeight = font != nullptr ? TTF_FontHeight(font) : 0;
+    }
+
+    GlyphAtlas::~GlyphAtlas()
+    {
+        for (SDL_Texture *page: pages)
+            SDL_DestroyTexture(page);
+    }
+
+    const GlyphAtlas::Glyph &GlyphAtlas::getGlyph(Uint32 codepoint)
+    {
+        auto it = glyphs.find(codepoint);
+        if (it != glyphs.end())
+            return it->second;
+
+        FRUITWORK_PROFILE_ZONE("GlyphAtlas::getGlyph");
+
+        Glyph &glyph = glyphs[codepoint];
+        if (font == nullptr)
+            return glyph;
+
+        int minX = 0, maxX = 0, minY = 0, maxY = 0;
+        TTF_GlyphMetrics32(font, codepoint, &minX, &maxX, &minY, &maxY, &glyph.advance);
+
+        // the surface starts at the pen, or further left if the glyph reaches back
+        glyph.offsetX = std::min(0, minX);
+
+        // whitespace has nothing to draw
+        if (maxX <= minX)
+            return glyph;
+
+        SDL_Surface *rendered = TTF_RenderGlyph32_Blended(font, codepoint, {255, 255, 255, 255});
+        if (rendered == nullptr)
+        {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to render glyph U+%04X: %s", codepoint, TTF_GetError());
+            return glyph;
+        }
+
+        SDL_Surface *surface = SDL_ConvertSurfaceFormat(rendered, SDL_PIXELFORMAT_ARGB8888, 0);
+        SDL_FreeSurface(rendered);
+
+        if (surface == nullptr)
+            return glyph;
+
+        SDL_Point position;
+        glyph.page = allocate(surface->w, surface->h, position);
+
+        if (glyph.page != nullptr)
+        {
+            glyph.source = {position.x, position.y, surface->w, surface->h};
+            SDL_UpdateTexture(glyph.page, &glyph.source, surface->pixels, surface->pitch);
+        }
+
+        SDL_FreeSurface(surface);
+
+        return glyph;
+    }
+
+    SDL_Texture *GlyphAtlas::allocate(int w, int h, SDL_Point &position)
+    {
+        if (w + 2 * GLYPH_PADDING > PAGE_SIZE || h + 2 * GLYPH_PADDING > PAGE_SIZE)
+        {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "A %dx%d glyph does not fit in the glyph atlas", w, h);
+            return nullptr;
+        }
+
+        // next shelf
+        if (shelfX + w + GLYPH_PADDING > PAGE_SIZE)
+        {
+            shelfX = GLYPH_PADDING;
+            shelfY += shelfHeight + GLYPH_PADDING;
+            shelfHeight = 0;
+        }
+
+        // next page
+        if (pages.empty() || shelfY + h + GLYPH_PADDING > PAGE_SIZE)
+        {
+            SDL_Texture *page = SDL_CreateTexture(sys.getRenderer(), SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, PAGE_SIZE, PAGE_SIZE);
+            if (page == nullptr)
+            {
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create a glyph atlas page: %s", SDL_GetError());
+                return nullptr;
+            }
+
+            // the contents of a new texture are undefined, the padding has to be transparent
+            std::vector<Uint32> clear(PAGE_SIZE * PAGE_SIZE, 0);
+            SDL_UpdateTexture(page, nullptr, clear.data(), PAGE_SIZE * (int) sizeof(Uint32));
+            SDL_SetTextureBlendMode(page, SDL_BLENDMODE_BLEND);
+
+            pages.push_back(page);
+            shelfX = GLYPH_PADDING;
+            shelfY = GLYPH_PADDING;
+            shelfHeight = 0;
+        }
+
+        position = {shelfX, shelfY};
+        shelfX += w + GLYPH_PADDING;
+        shelfHeight = std::max(shelfHeight, h);
+
+        return pages.back();
+    }
+
+    void GlyphAtlas::layout(const std::string &text, TextLayout &layout, int wrapWidth)
+    {
+        layout.glyphs.clear();
+        layout.width = 0;
+        layout.height = 0;
+
+        if (text.empty())
+            return;
+
+        int penX = 0, lineY = 0;
+        Uint32 previous = 0;
+
+        // the last space on the current line, where it can be broken when wrapping
+        size_t breakGlyph = std::string::npos;
+        int breakLineWidth = 0, breakX = 0;
+
+        size_t index = 0;
+        while (index < text.size())
+        {
+            Uint32 codepoint = decodeUtf8(text, index);
+
+            if (codepoint == '\n')
+            {
+                layout.width = std::max(layout.width, penX);
+                penX = 0;
+                lineY += lineSkip;
+                previous = 0;
+                breakGlyph = std::string::npos;
+                continue;
+            }
+
+            const Glyph &glyph = getGlyph(codepoint);
+
+            if (kerning && previous != 0)
+                penX += TTF_GetFontKerningSizeGlyphs32(font, previous, codepoint);
+
+            // move the word after the last space to the next line
+            if (wrapWidth > 0 && penX + glyph.advance > wrapWidth && breakGlyph != std::string::npos)
+            {
+                for (size_t i = breakGlyph; i < layout.glyphs.size(); i++)
+                {
+                    layout.glyphs[i].destination.x -= breakX;
+                    layout.glyphs[i].destination.y += lineSkip;
+                }
+
+                layout.width = std::max(layout.width, breakLineWidth);
+                penX -= breakX;
+                lineY += lineSkip;
+                breakGlyph = std::string::npos;
+            }
+
+            if (codepoint == ' ')
+            {
+                breakGlyph = layout.glyphs.size();
+                breakLineWidth = penX;
+                breakX = penX + glyph.advance;
+            }
+
+            if (glyph.page != nullptr)
+                layout.glyphs.push_back({glyph.page, glyph.source, {penX + glyph.offsetX, lineY, glyph.source.w, glyph.source.h}});
+
+            penX += glyph.advance;
+            previous = codepoint;
+        }
+
+        layout.width = std::max(layout.width, penX);
+        layout.height = lineY + fontHeight;
+    }
+
+    int GlyphAtlas::measure(const std::string &text)
+    {
+        int width = 0;
+        Uint32 previous = 0;
+
+        size_t index = 0;
+        while (index < text.size())
+        {
+            Uint32 codepoint = decodeUtf8(text, index);
+            width += getAdvance(codepoint, previous);
+            previous = codepoint;
+        }
+
+        return width;
+    }
+
+    int GlyphAtlas::getAdvance(Uint32 codepoint, Uint32 previous)
+    {
+        int advance = getGlyph(codepoint).advance;
+
+        if (kerning && previous != 0)
+            advance += TTF_GetFontKerningSizeGlyphs32(font, previous, codepoint);
+
+        return advance;
+    }
+
+    void GlyphAtlas::TextLayout::draw(SDL_Point position, SDL_Color color, float scale) const
+    {
+        RenderQueue *queue = RenderQueue::getInstance();
+
+        for (const PlacedGlyph &glyph: glyphs)
+        {
+            SDL_Rect destination = glyph.destination;
+
+            if (scale != 1)
+            {
+                destination = {(int) std::lround(destination.x * scale), (int) std::lround(destination.y * scale),
+                               (int) std::lround(destination.w * scale), (int) std::lround(destination.h * scale)};
+            }
+
+            destination.x += position.x;
+            destination.y += position.y;
+
+            queue->submit(glyph.page, &glyph.source, destination, 0, nullptr, SDL_FLIP_NONE, color);
+        }
+    }
+
+} // fruitwork
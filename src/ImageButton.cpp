@@ -1,4 +1,3 @@
-#include <SDL_image.h>
 #include "ImageButton.h"
 #include "System.h"
 
@@ -14,6 +13,16 @@ namespace fruitwork
         return new ImageButton(x, y, w, h, texturePath);
     }
 
+    ImageButton *ImageButton::getInstance(int x, int y, int w, int h, const TextureAtlas::Region &region)
+    {
+        return new ImageButton(x, y, w, h, region);
+    }
+
+    ImageButton *ImageButton::getAtlasInstance(int x, int y, int w, int h, const std::string &imageName)
+    {
+        return new ImageButton(x, y, w, h, TextureAtlas::getImage(imageName));
+    }
+
     ImageButton::ImageButton(int x, int y, int w, int h, const std::string &texturePath) : Button(x, y, w, h, "")
     {
         sprite = ResponsiveSprite::getInstance(0, 0, w, h, texturePath);
@@ -26,6 +35,12 @@ namespace fruitwork
         isSpriteOwner = false;
     }
 
+    ImageButton::ImageButton(int x, int y, int w, int h, const TextureAtlas::Region &region) : Button(x, y, w, h, "")
+    {
+        sprite = ResponsiveSprite::getInstance(0, 0, w, h, region);
+        isSpriteOwner = true;
+    }
+
     void ImageButton::start()
     {
         Button::start();
@@ -1,7 +1,8 @@
-#include <SDL_image.h>
 #include "InputField.h"
+#include <algorithm>
 #include "ResourceManager.h"
 #include "System.h"
+#include "RenderQueue.h"
 
 namespace fruitwork
 {
@@ -13,16 +14,11 @@ namespace fruitwork
     InputField::InputField(int x, int y, int w, int h, const std::string &placeholderText, InputType inputType)
             : Component(x, y, w, h), inputType(inputType), placeholderText(placeholderText)
     {
-        textureLeft = IMG_LoadTexture(fruitwork::sys.getRenderer(), ResourceManager::getTexturePath("button-left.png").c_str());
-        textureMiddle = IMG_LoadTexture(fruitwork::sys.getRenderer(), ResourceManager::getTexturePath("button-middle.png").c_str());
-        textureRight = IMG_LoadTexture(fruitwork::sys.getRenderer(), ResourceManager::getTexturePath("button-right.png").c_str());
+        textureLeft = ResourceManager::getTexture(ResourceManager::getTexturePath("button-left.png"));
+        textureMiddle = ResourceManager::getTexture(ResourceManager::getTexturePath("button-middle.png"));
+        textureRight = ResourceManager::getTexture(ResourceManager::getTexturePath("button-right.png"));
 
-        // 1x1 pixel to stretch
-        caretTexture = SDL_CreateTexture(fruitwork::sys.getRenderer(), SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, 1, 1);
-
-        SDL_Surface *placeholderSurface = TTF_RenderText_Blended(sys.getFont(), placeholderText.c_str(), {0, 0, 0, 128});
-        placeholderTexture = SDL_CreateTextureFromSurface(fruitwork::sys.getRenderer(), placeholderSurface);
-        SDL_FreeSurface(placeholderSurface);
+        GlyphAtlas::getInstance(sys.getFont())->layout(placeholderText, placeholderLayout);
     }
 
     void InputField::draw() const
@@ -34,46 +30,28 @@ namespace fruitwork
         SDL_Rect middleRect = {rect.x + 8, rect.y, rect.w - 16, rect.h};
         SDL_Rect rightRect = {rect.x + rect.w - 8, rect.y, 8, rect.h};
 
-        const int color = isFocused ? 240 : 255;
-        SDL_SetTextureColorMod(textureLeft, color, color, color);
-        SDL_SetTextureColorMod(textureMiddle, color, color, color);
-        SDL_SetTextureColorMod(textureRight, color, color, color);
+        const Uint8 shade = isFocused ? 240 : 255;
+        const SDL_Color color = {shade, shade, shade, 255};
 
-        SDL_RenderCopy(fruitwork::sys.getRenderer(), textureLeft, nullptr, &leftRect);
-        SDL_RenderCopy(fruitwork::sys.getRenderer(), textureMiddle, nullptr, &middleRect);
-        SDL_RenderCopy(fruitwork::sys.getRenderer(), textureRight, nullptr, &rightRect);
+        RenderQueue *queue = RenderQueue::getInstance();
+        queue->submit(textureLeft.get(), nullptr, leftRect, 0, nullptr, SDL_FLIP_NONE, color);
+        queue->submit(textureMiddle.get(), nullptr, middleRect, 0, nullptr, SDL_FLIP_NONE, color);
+        queue->submit(textureRight.get(), nullptr, rightRect, 0, nullptr, SDL_FLIP_NONE, color);
 
         // draw text with padding
-        SDL_Texture *texture = usePlaceholder ? placeholderTexture : textTexture;
-        SDL_Rect textRect = {rect.x + 10, rect.y + 10, rect.w - 20, rect.h - 20};
-        int w, h;
-        SDL_QueryTexture(texture, nullptr, nullptr, &w, &h);
-        textRect.w = w;
-        textRect.h = h;
-        SDL_RenderCopy(fruitwork::sys.getRenderer(), texture, nullptr, &textRect);
+        if (usePlaceholder)
+            placeholderLayout.draw({rect.x + 10, rect.y + 10}, {0, 0, 0, 128});
+        else
+            textLayout.draw({rect.x + 10, rect.y + 10}, {0, 0, 0, 255});
 
         // draw caret
         if (caretVisible && isFocused)
         {
-            SDL_SetRenderDrawColor(fruitwork::sys.getRenderer(), 0, 0, 0, 255);
-
             SDL_Rect caretRect = {rect.x + 10, rect.y + 10, 2, rect.h - 20};
 
-            if (caretPosition > 0)
-            {
-                std::string shownText = inputType == InputType::PASSWORD ? getPasswordMask() : text;
-
-                SDL_Surface *tmpSurface = TTF_RenderText_Blended(sys.getFont(), shownText.substr(0, caretPosition).c_str(), {0, 0, 0, 255});
-                SDL_Texture *tmpTexture = SDL_CreateTextureFromSurface(fruitwork::sys.getRenderer(), tmpSurface);
-                SDL_FreeSurface(tmpSurface);
-
-                SDL_QueryTexture(tmpTexture, nullptr, nullptr, &caretRect.x, nullptr);
-                SDL_DestroyTexture(tmpTexture);
-
-                caretRect.x += rect.x + 10;
-            }
+            caretRect.x += caretOffsets[caretPosition];
 
-            SDL_RenderCopy(fruitwork::sys.getRenderer(), caretTexture, nullptr, &caretRect);
+            queue->submit(nullptr, nullptr, caretRect, 0, nullptr, SDL_FLIP_NONE, {0, 0, 0, 255});
         }
     }
 
@@ -109,11 +87,17 @@ namespace fruitwork
         SDL_GetMouseState(&mousePos.x, &mousePos.y);
         bool inRect = SDL_PointInRect(&mousePos, &getRect());
 
-        if (inRect && !isFocused)
+        if (inRect)
         {
-            isFocused = true;
-            setListenerState(true);
-            caretPosition = text.length();
+            if (!isFocused)
+            {
+                isFocused = true;
+                setListenerState(true);
+            }
+
+            caretPosition = getCaretPositionAt(mousePos.x - getRect().x - 10);
+            caretBlinkCounter = 0;
+            caretVisible = true;
         }
         else if (!inRect && isFocused)
         {
@@ -137,7 +121,7 @@ namespace fruitwork
             }
 
             text.insert(caretPosition, event.text.text);
-            setText(text);
+            updateText(caretPosition);
 
             caretBlinkCounter = 0;
             caretVisible = true; // the caret is always visible when typing
@@ -156,7 +140,7 @@ namespace fruitwork
                 if (text.length() > 0)
                 {
                     text.erase(caretPosition - 1, 1);
-                    setText(text); // update texture
+                    updateText(caretPosition - 1);
 
                     caretBlinkCounter = 0;
                     caretVisible = true; // the caret is always visible when typing
@@ -168,7 +152,7 @@ namespace fruitwork
                 if (text.length() > 0)
                 {
                     text.erase(caretPosition, 1);
-                    setText(text); // update texture
+                    updateText(caretPosition);
 
                     caretBlinkCounter = 0;
                     caretVisible = true; // the caret is always visible when typing
@@ -200,22 +184,67 @@ namespace fruitwork
     void InputField::setText(const std::string &t)
     {
         this->text = t;
-        std::string shownText = inputType == InputType::PASSWORD ? getPasswordMask() : t;
+        caretPosition = std::min(caretPosition, (int) text.length());
+        updateText(0);
+    }
+
+    void InputField::updateText(size_t changedFrom)
+    {
+        shownText = inputType == InputType::PASSWORD ? getPasswordMask() : text;
 
-        SDL_DestroyTexture(textTexture);
-        SDL_Surface *surface = TTF_RenderText_Blended(sys.getFont(), shownText.c_str(), {0, 0, 0});
-        textTexture = SDL_CreateTextureFromSurface(fruitwork::sys.getRenderer(), surface);
-        SDL_FreeSurface(surface);
+        GlyphAtlas *atlas = GlyphAtlas::getInstance(sys.getFont());
+        atlas->layout(shownText, textLayout);
+
+        // the offsets before the change stay the same, continue the running sum from the start of the changed character
+        size_t index = std::min(changedFrom, shownText.size());
+        while (index > 0 && (shownText[index] & 0xC0) == 0x80)
+            index--;
+
+        // the character before it, kerned against the first changed one
+        Uint32 previous = 0;
+        if (index > 0)
+        {
+            size_t previousIndex = index - 1;
+            while (previousIndex > 0 && (shownText[previousIndex] & 0xC0) == 0x80)
+                previousIndex--;
+
+            previous = GlyphAtlas::decodeUtf8(shownText, previousIndex);
+        }
+
+        caretOffsets.resize(shownText.size() + 1);
+        int x = index > 0 ? caretOffsets[index] : 0;
+
+        while (index < shownText.size())
+        {
+            size_t start = index;
+            Uint32 codepoint = GlyphAtlas::decodeUtf8(shownText, index);
+
+            for (size_t i = start; i < index; i++)
+                caretOffsets[i] = x;
+
+            x += atlas->getAdvance(codepoint, previous);
+            previous = codepoint;
+        }
+
+        caretOffsets[shownText.size()] = x;
     }
 
-    InputField::~InputField()
+    int InputField::getCaretPositionAt(int x) const
     {
-        SDL_DestroyTexture(textureLeft);
-        SDL_DestroyTexture(textureMiddle);
-        SDL_DestroyTexture(textureRight);
-        SDL_DestroyTexture(caretTexture);
-        SDL_DestroyTexture(textTexture);
-        SDL_DestroyTexture(placeholderTexture);
+        // the first offset past x, then whichever of it and the character boundary before it is closer
+        auto it = std::upper_bound(caretOffsets.begin(), caretOffsets.end(), x);
+        if (it == caretOffsets.end())
+            return (int) text.length();
+
+        int after = (int) (it - caretOffsets.begin());
+        if (after == 0)
+            return 0;
+
+        int before = after - 1;
+        while (before > 0 && (shownText[before] & 0xC0) == 0x80)
+            before--;
+
+        return x - caretOffsets[before] <= caretOffsets[after] - x ? before : after;
     }
 
     int InputField::listenerCount = 0;
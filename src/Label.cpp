@@ -4,6 +4,7 @@
 #include <SDL_ttf.h>
 #include <iostream>
 #include "ResourceManager.h"
+#include "Profiler.h"
 
 namespace fruitwork
 {
@@ -13,65 +14,58 @@ namespace fruitwork
     }
 
     Label::Label(int x, int y, int w, int h, // NOLINT
-                 const std::string &text) : Component(x, y, w, h), text(text)
-    {
-        setText(text);
-    }
-
-    void Label::update()
-    {
-        Component::update();
-        SDL_Rect currentRect = getAbsoluteRect();
-        if (!SDL_RectEquals(&currentRect, &lastAbsoluteDrawnRect))
-            setText(text);
-    }
+                 const std::string &text) : Component(x, y, w, h), text(text) {}
 
     void Label::draw() const
     {
-        SDL_RenderCopy(sys.getRenderer(), texture, nullptr, &drawRect);
+        updateLayout();
+        textLayout.draw({drawRect.x, drawRect.y}, color, textScale);
     }
 
-    Label::~Label()
+    void Label::updateLayout() const
     {
-        SDL_DestroyTexture(texture);
-        TTF_CloseFont(font);
-    }
+        SDL_Rect absoluteRect = getAbsoluteRect();
 
-    std::string Label::getText() const { return text; }
-
-    void Label::setText(const std::string &t)
-    {
-        text = t;
+        if (!layoutDirty)
+        {
+            if (absoluteRect.x == lastAbsoluteDrawnRect.x && absoluteRect.y == lastAbsoluteDrawnRect.y
+                && absoluteRect.w == lastAbsoluteDrawnRect.w)
+                return;
+
+            // only moved, the layout stays the same
+            if (absoluteRect.w == lastAbsoluteDrawnRect.w)
+            {
+                drawRect.x += absoluteRect.x - lastAbsoluteDrawnRect.x;
+                drawRect.y += absoluteRect.y - lastAbsoluteDrawnRect.y;
+                lastAbsoluteDrawnRect = absoluteRect;
+                return;
+            }
+        }
 
-        SDL_DestroyTexture(texture);
+        FRUITWORK_PROFILE_ZONE("Label::updateLayout");
 
-        if (isFontOwner)
+        if (fontDirty && isFontOwner)
         {
-            TTF_CloseFont(font);
-            font = TTF_OpenFont(fontPath.c_str(), fontSize);
+            fontHandle = ResourceManager::getFont(fontPath, fontSize);
+            font = fontHandle.get();
         }
 
-        drawRect = getAbsoluteRect();
+        fontDirty = false;
 
-        SDL_Surface *surface;
-        if (allowWrap)
-            surface = TTF_RenderUTF8_Blended_Wrapped(font, text.c_str(), color, drawRect.w * 1.1);
-        else
-            surface = TTF_RenderUTF8_Blended(font, text.c_str(), color);
+        drawRect = absoluteRect;
 
-        texture = SDL_CreateTextureFromSurface(sys.getRenderer(), surface);
-        SDL_FreeSurface(surface);
+        GlyphAtlas::getInstance(font)->layout(text, textLayout, allowWrap ? (int) (drawRect.w * 1.1) : 0);
 
         // set the draw rect
-        int textWidth, textHeight;
-        SDL_QueryTexture(texture, nullptr, nullptr, &textWidth, &textHeight);
+        int textWidth = textLayout.width, textHeight = textLayout.height;
 
         // drawRect can not be larger than the component's rect, scale x and y down by the same % if necessary
+        textScale = 1;
         if (textWidth > drawRect.w)
         {
-            float scale = static_cast<float>(drawRect.w) / textWidth;
-            textWidth = static_cast<int>(textWidth * scale);
-            textHeight = static_cast<int>(textHeight * scale);
+            textScale = static_cast<float>(drawRect.w) / textWidth;
+            textWidth = static_cast<int>(textWidth * textScale);
+            textHeight = static_cast<int>(textHeight * textScale);
         }
 
         drawRect.w = textWidth;
@@ -82,49 +76,72 @@ namespace fruitwork
             case Alignment::LEFT:
                 break;
             case Alignment::CENTER:
-                drawRect.x += (getAbsoluteRect().w - textWidth) / 2; // Full width minus text width divided by 2
+                drawRect.x += (absoluteRect.w - textWidth) / 2; // Full width minus text width divided by 2
                 break;
             case Alignment::RIGHT:
-                drawRect.x += getAbsoluteRect().w - textWidth; // Full width minus text width
+                drawRect.x += absoluteRect.w - textWidth; // Full width minus text width
                 break;
         }
 
-        lastAbsoluteDrawnRect = getAbsoluteRect();
+        lastAbsoluteDrawnRect = absoluteRect;
+        layoutDirty = false;
+    }
+
+    std::string Label::getText() const { return text; }
+
+    void Label::setText(const std::string &t)
+    {
+        if (t == text)
+            return;
+
+        text = t;
+        layoutDirty = true;
     }
 
     void Label::setColor(const SDL_Color &c)
     {
+        // the color is applied when drawing, the layout stays the same
         this->color = c;
-        setText(text);
     }
 
     void Label::setFontSize(const int size)
     {
+        if (size == fontSize)
+            return;
+
         this->fontSize = size;
-        setText(text);
+        fontDirty = true;
+        layoutDirty = true;
     }
 
     void Label::setFontPath(const std::string &f)
     {
+        if (f == fontPath && isFontOwner)
+            return;
+
         this->fontPath = f;
         this->isFontOwner = true;
-        setText(text);
+        fontDirty = true;
+        layoutDirty = true;
     }
 
     void Label::setFont(TTF_Font *f)
     {
-        if (this->isFontOwner)
-            TTF_CloseFont(this->font);
+        fontHandle = nullptr;
 
         this->font = f;
         this->isFontOwner = false;
-        setText(text);
+        fontDirty = false;
+        layoutDirty = true;
     }
 
     void Label::setAlignment(Label::Alignment a)
     {
+        if (a == alignment)
+            return;
+
         this->alignment = a;
-        setText(text);
+        layoutDirty = true;
     }
 
 } // fruitwork
\ No newline at end of file
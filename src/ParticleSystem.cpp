@@ -0,0 +1,247 @@
+#include <cmath>
+#include <algorithm>
+#include "ParticleSystem.h"
+#include "RenderQueue.h"
+#include "Profiler.h"
+
+namespace fruitwork
+{
+    /** Replace an element with the last one, order doesn't matter. */
+    template<typename T>
+    static void swapRemove(std::vector<T> &values, size_t index)
+    {
+        values[index] = values.back();
+        values.pop_back();
+    }
+
+    ParticleSystem *ParticleSystem::getInstance(int x, int y, int w, int h, const std::string &texturePath)
+    {
+        return new ParticleSystem(x, y, w, h, texturePath);
+    }
+
+    ParticleSystem::ParticleSystem(int x, int y, int w, int h, const std::string &texturePath)
+            : Component(x, y, w, h), random(std::random_device()())
+    {
+        texture = ResourceManager::getTexture(texturePath);
+    }
+
+    int ParticleSystem::addEmitter(const Emitter &emitter)
+    {
+        EmitterState state;
+        state.emitter = emitter;
+        emitters.push_back(state);
+
+        return (int) emitters.size() - 1;
+    }
+
+    void ParticleSystem::burst(int emitter, int count, float duration)
+    {
+        const Emitter &e = emitters[emitter].emitter;
+        burst(emitter, count, duration, e.angle, e.spread);
+    }
+
+    void ParticleSystem::burst(int emitter, int count, float duration, float angle, float spread)
+    {
+        if (duration <= 0)
+        {
+            emit(emitter, count, angle, spread);
+            return;
+        }
+
+        // the first particle leaves right away
+        bursts.push_back({emitter, count, count / duration, 1, angle, spread});
+    }
+
+    int ParticleSystem::getParticleCount(int emitter) const
+    {
+        return (int) std::count(particles.emitter.begin(), particles.emitter.end(), emitter);
+    }
+
+    void ParticleSystem::clear()
+    {
+        for (EmitterState &state: emitters)
+            state.rateAccumulator = 0;
+
+        bursts.clear();
+        particles = Particles();
+    }
+
+    void ParticleSystem::update(float elapsedTime)
+    {
+        Component::update(elapsedTime);
+
+        FRUITWORK_PROFILE_ZONE("ParticleSystem::update");
+
+        for (int i = 0; i < (int) emitters.size(); i++)
+        {
+            EmitterState &state = emitters[i];
+
+            state.rateAccumulator += state.emitter.rate * elapsedTime;
+            int count = (int) state.rateAccumulator;
+            state.rateAccumulator -= (float) count;
+
+            if (count > 0)
+                emit(i, count, state.emitter.angle, state.emitter.spread);
+        }
+
+        // from the back, so the burst moved into the slot of a finished one has been done already
+        for (size_t i = bursts.size(); i-- > 0;)
+        {
+            Burst &b = bursts[i];
+            b.accumulator += b.rate * elapsedTime;
+
+            int count = std::min(b.remaining, (int) b.accumulator);
+            b.accumulator -= (float) count;
+            b.remaining -= count;
+
+            if (count > 0)
+                emit(b.emitter, count, b.angle, b.spread);
+
+            if (b.remaining <= 0)
+                swapRemove(bursts, i);
+        }
+
+        size_t count = particles.x.size();
+
+        float *x = particles.x.data(), *y = particles.y.data();
+        float *velocityX = particles.velocityX.data(), *velocityY = particles.velocityY.data();
+        float *rotation = particles.rotation.data(), *angularVelocity = particles.angularVelocity.data();
+        float *age = particles.age.data();
+
+        std::copy(x, x + count, particles.previousX.data());
+        std::copy(y, y + count, particles.previousY.data());
+
+        // one property per loop, so the compiler can vectorize them
+        float damping = std::max(0.0f, 1 - drag * elapsedTime);
+        float fall = gravity * elapsedTime;
+
+        for (size_t i = 0; i < count; i++)
+            velocityX[i] *= damping;
+
+        for (size_t i = 0; i < count; i++)
+            velocityY[i] = velocityY[i] * damping + fall;
+
+        for (size_t i = 0; i < count; i++)
+            x[i] += velocityX[i] * elapsedTime;
+
+        for (size_t i = 0; i < count; i++)
+            y[i] += velocityY[i] * elapsedTime;
+
+        for (size_t i = 0; i < count; i++)
+            rotation[i] += angularVelocity[i] * elapsedTime;
+
+        for (size_t i = 0; i < count; i++)
+            age[i] += elapsedTime;
+
+        // from the back, so the particle moved into a freed slot has been checked already
+        for (size_t i = count; i-- > 0;)
+        {
+            if (particles.age[i] >= particles.lifetime[i])
+                remove(i);
+        }
+    }
+
+    void ParticleSystem::interpolate(float alpha)
+    {
+        Component::interpolate(alpha);
+        interpolationAlpha = alpha;
+    }
+
+    void ParticleSystem::draw() const
+    {
+        size_t count = particles.x.size();
+        if (count == 0)
+            return;
+
+        FRUITWORK_PROFILE_ZONE("ParticleSystem::draw");
+
+        SDL_Vertex *vertex = RenderQueue::getInstance()->reserveQuads(texture.get(), (int) count);
+
+        for (size_t i = 0; i < count; i++, vertex += 4)
+        {
+            const Emitter &emitter = emitters[particles.emitter[i]].emitter;
+            float t = particles.age[i] / particles.lifetime[i];
+
+            float alpha = std::min(1.0f, std::max(0.0f, emitter.alpha.evaluate(t)));
+            float scale = emitter.scale.evaluate(t);
+            float halfW = (float) emitter.size.x * scale / 2, halfH = (float) emitter.size.y * scale / 2;
+
+            float centerX = particles.previousX[i] + (particles.x[i] - particles.previousX[i]) * interpolationAlpha;
+            float centerY = particles.previousY[i] + (particles.y[i] - particles.previousY[i]) * interpolationAlpha;
+
+            // the corners rotated around the center, top left, top right, bottom right, bottom left
+            float cosRotation = std::cos(particles.rotation[i]), sinRotation = std::sin(particles.rotation[i]);
+            float rightX = halfW * cosRotation, rightY = halfW * sinRotation;
+            float downX = -halfH * sinRotation, downY = halfH * cosRotation;
+
+            SDL_Color color = particles.color[i];
+            color.a = (Uint8) (color.a * alpha);
+
+            vertex[0] = {{centerX - rightX - downX, centerY - rightY - downY}, color, {0, 0}};
+            vertex[1] = {{centerX + rightX - downX, centerY + rightY - downY}, color, {1, 0}};
+            vertex[2] = {{centerX + rightX + downX, centerY + rightY + downY}, color, {1, 1}};
+            vertex[3] = {{centerX - rightX + downX, centerY - rightY + downY}, color, {0, 1}};
+        }
+    }
+
+    void ParticleSystem::emit(int emitter, int count, float angle, float spread)
+    {
+        count = std::min(count, maxParticles - getParticleCount());
+        if (count <= 0)
+            return;
+
+        const Emitter &e = emitters[emitter].emitter;
+        const SDL_Rect &rect = getAbsoluteRect();
+        float originX = (float) rect.x + e.position.x, originY = (float) rect.y + e.position.y;
+
+        const float toRadians = (float) M_PI / 180;
+
+        for (int i = 0; i < count; i++)
+        {
+            float direction = randomRange(angle - spread / 2, angle + spread / 2) * toRadians;
+            float speed = randomRange(e.minSpeed, e.maxSpeed);
+
+            particles.x.push_back(originX);
+            particles.y.push_back(originY);
+            particles.previousX.push_back(originX);
+            particles.previousY.push_back(originY);
+            particles.velocityX.push_back(std::cos(direction) * speed * e.speedScale.x);
+            particles.velocityY.push_back(std::sin(direction) * speed * e.speedScale.y);
+            particles.rotation.push_back(randomRange(e.minRotation, e.maxRotation) * toRadians);
+            particles.angularVelocity.push_back(randomRange(e.minAngularVelocity, e.maxAngularVelocity) * toRadians);
+            particles.age.push_back(0);
+            particles.lifetime.push_back(std::max(0.001f, randomRange(e.minLifetime, e.maxLifetime)));
+            particles.emitter.push_back(emitter);
+
+            if (e.colors.empty())
+                particles.color.push_back({255, 255, 255, 255});
+            else
+                particles.color.push_back(e.colors[std::uniform_int_distribution<size_t>(0, e.colors.size() - 1)(random)]);
+        }
+    }
+
+    void ParticleSystem::remove(size_t index)
+    {
+        swapRemove(particles.x, index);
+        swapRemove(particles.y, index);
+        swapRemove(particles.previousX, index);
+        swapRemove(particles.previousY, index);
+        swapRemove(particles.velocityX, index);
+        swapRemove(particles.velocityY, index);
+        swapRemove(particles.rotation, index);
+        swapRemove(particles.angularVelocity, index);
+        swapRemove(particles.age, index);
+        swapRemove(particles.lifetime, index);
+        swapRemove(particles.color, index);
+        swapRemove(particles.emitter, index);
+    }
+
+    float ParticleSystem::randomRange(float min, float max)
+    {
+        if (max <= min)
+            return min;
+
+        return std::uniform_real_distribution<float>(min, max)(random);
+    }
+
+} // fruitwork
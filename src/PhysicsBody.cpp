@@ -13,12 +13,15 @@ namespace fruitwork
     {
         position.x = rect.x * 1.0f;
         position.y = rect.y * 1.0f;
+        previousPosition = position;
     }
 
     PhysicsBody::~PhysicsBody() = default;
 
     void PhysicsBody::update(float elapsedTime)
     {
+        previousPosition = position;
+
         // apply friction and gravity, with mass taken into account
         acceleration.x = -velocity.x * (1 - friction) / mass;
         acceleration.y = -velocity.y * (1 - friction) / mass + gravityScale * GRAVITY;
@@ -109,6 +112,14 @@ namespace fruitwork
         rect.y = static_cast<int>(position.y);
     }
 
+    SDL_Rect PhysicsBody::getInterpolatedRect(float alpha) const
+    {
+        SDL_Rect r = rect;
+        r.x = static_cast<int>(previousPosition.x + (position.x - previousPosition.x) * alpha);
+        r.y = static_cast<int>(previousPosition.y + (position.y - previousPosition.y) * alpha);
+        return r;
+    }
+
     void PhysicsBody::addForce(float x, float y)
     {
         velocity.x += x / mass;
@@ -0,0 +1,492 @@
+#include <queue>
+#include <cmath>
+#include <algorithm>
+#include "PhysicsWorld.h"
+#include "Component.h"
+
+namespace fruitwork
+{
+#pragma region Bodies
+
+    void PhysicsWorld::sync(const ComponentView &components)
+    {
+        syncStamp++;
+
+        for (Component *component: components)
+        {
+            PhysicsBody *body = component->getPhysicsBody();
+            if (body == nullptr)
+                continue;
+
+            AABB exact = toAABB(body->getRect());
+            auto it = proxies.find(body);
+
+            if (it == proxies.end())
+            {
+                int leaf = allocateNode();
+                nodes[leaf].box = fatten(exact);
+                nodes[leaf].height = 0;
+                nodes[leaf].body = body;
+                insertLeaf(leaf);
+                proxies[body] = leaf;
+                it = proxies.find(body);
+            }
+            else if (!contains(nodes[it->second].box, exact))
+            {
+                // moved out of its fat box, re-insert it with a new one
+                removeLeaf(it->second);
+                nodes[it->second].box = fatten(exact);
+                insertLeaf(it->second);
+            }
+
+            Node &leaf = nodes[it->second];
+            leaf.component = component;
+            leaf.bodyBox = exact;
+            leaf.lastSeen = syncStamp;
+        }
+
+        // remove bodies that are no longer part of the components, without touching the (possibly deleted) body itself
+        for (auto it = proxies.begin(); it != proxies.end();)
+        {
+            if (nodes[it->second].lastSeen != syncStamp)
+            {
+                removeLeaf(it->second);
+                freeNode(it->second);
+                it = proxies.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    void PhysicsWorld::removeBody(const PhysicsBody *body)
+    {
+        if (body == nullptr)
+            return;
+
+        auto it = proxies.find(body);
+        if (it == proxies.end())
+            return;
+
+        removeLeaf(it->second);
+        freeNode(it->second);
+        proxies.erase(it);
+    }
+
+    void PhysicsWorld::clear()
+    {
+        nodes.clear();
+        proxies.clear();
+        root = -1;
+        freeList = -1;
+    }
+
+#pragma endregion
+
+#pragma region Queries
+
+    void PhysicsWorld::queryPoint(SDL_FPoint point, const HitCallback &callback) const
+    {
+        auto inside = [point](const AABB &b)
+        {
+            return point.x >= b.minX && point.x < b.maxX && point.y >= b.minY && point.y < b.maxY;
+        };
+
+        bestFirst([inside](const AABB &b)
+                  {
+                      return inside(b) ? 0.0f : -1.0f;
+                  },
+                  [inside, point](const AABB &b)
+                  {
+                      if (!inside(b))
+                          return -1.0f;
+
+                      return std::hypot((b.minX + b.maxX) / 2 - point.x, (b.minY + b.maxY) / 2 - point.y);
+                  },
+                  callback);
+    }
+
+    std::vector<PhysicsWorld::Hit> PhysicsWorld::queryPoint(SDL_FPoint point) const
+    {
+        std::vector<Hit> hits;
+        queryPoint(point, [&hits](const Hit &hit)
+        {
+            hits.push_back(hit);
+            return true;
+        });
+        return hits;
+    }
+
+    void PhysicsWorld::queryRect(const SDL_Rect &rect, const HitCallback &callback) const
+    {
+        AABB query = toAABB(rect);
+        float centerX = (query.minX + query.maxX) / 2;
+        float centerY = (query.minY + query.maxY) / 2;
+
+        auto overlaps = [query](const AABB &b)
+        {
+            return query.minX < b.maxX && b.minX < query.maxX && query.minY < b.maxY && b.minY < query.maxY;
+        };
+
+        bestFirst([overlaps, centerX, centerY](const AABB &b)
+                  {
+                      if (!overlaps(b))
+                          return -1.0f;
+
+                      // nothing inside the box can have its center closer than the box itself
+                      float dx = std::max({b.minX - centerX, 0.0f, centerX - b.maxX});
+                      float dy = std::max({b.minY - centerY, 0.0f, centerY - b.maxY});
+                      return std::hypot(dx, dy);
+                  },
+                  [overlaps, centerX, centerY](const AABB &b)
+                  {
+                      if (!overlaps(b))
+                          return -1.0f;
+
+                      return std::hypot((b.minX + b.maxX) / 2 - centerX, (b.minY + b.maxY) / 2 - centerY);
+                  },
+                  callback);
+    }
+
+    std::vector<PhysicsWorld::Hit> PhysicsWorld::queryRect(const SDL_Rect &rect) const
+    {
+        std::vector<Hit> hits;
+        queryRect(rect, [&hits](const Hit &hit)
+        {
+            hits.push_back(hit);
+            return true;
+        });
+        return hits;
+    }
+
+    void PhysicsWorld::raycast(SDL_FPoint origin, SDL_FPoint direction, float maxDistance, const HitCallback &callback) const
+    {
+        float length = std::hypot(direction.x, direction.y);
+        if (length == 0.0f)
+        {
+            SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Cannot raycast without a direction.");
+            return;
+        }
+
+        SDL_FPoint dir = {direction.x / length, direction.y / length};
+
+        // slab test, returns how far along the ray it enters the box or -1 if it misses
+        auto entry = [origin, dir, maxDistance](const AABB &b)
+        {
+            float tMin = 0.0f;
+            float tMax = maxDistance;
+
+            const float o[2] = {origin.x, origin.y};
+            const float d[2] = {dir.x, dir.y};
+            const float min[2] = {b.minX, b.minY};
+            const float max[2] = {b.maxX, b.maxY};
+
+            for (int axis = 0; axis < 2; axis++)
+            {
+                if (std::fabs(d[axis]) < 1e-6f)
+                {
+                    if (o[axis] < min[axis] || o[axis] > max[axis])
+                        return -1.0f;
+
+                    continue;
+                }
+
+                float t1 = (min[axis] - o[axis]) / d[axis];
+                float t2 = (max[axis] - o[axis]) / d[axis];
+                if (t1 > t2)
+                    std::swap(t1, t2);
+
+                tMin = std::max(tMin, t1);
+                tMax = std::min(tMax, t2);
+                if (tMin > tMax)
+                    return -1.0f;
+            }
+
+            return tMin;
+        };
+
+        bestFirst(entry, entry, callback);
+    }
+
+    std::vector<PhysicsWorld::Hit> PhysicsWorld::raycast(SDL_FPoint origin, SDL_FPoint direction, float maxDistance) const
+    {
+        std::vector<Hit> hits;
+        raycast(origin, direction, maxDistance, [&hits](const Hit &hit)
+        {
+            hits.push_back(hit);
+            return true;
+        });
+        return hits;
+    }
+
+    void PhysicsWorld::bestFirst(const std::function<float(const AABB &)> &nodeDistance,
+                                 const std::function<float(const AABB &)> &leafDistance,
+                                 const HitCallback &callback) const
+    {
+        if (root == -1)
+            return;
+
+        struct Candidate {
+            float distance;
+            int node;
+        };
+
+        auto farther = [](const Candidate &a, const Candidate &b) { return a.distance > b.distance; };
+        std::priority_queue<Candidate, std::vector<Candidate>, decltype(farther)> queue(farther);
+
+        auto push = [&](int index)
+        {
+            float distance = nodeDistance(nodes[index].box);
+            if (distance >= 0 && isLeaf(index))
+                distance = leafDistance(nodes[index].bodyBox);
+
+            if (distance >= 0)
+                queue.push({distance, index});
+        };
+
+        push(root);
+
+        while (!queue.empty())
+        {
+            Candidate candidate = queue.top();
+            queue.pop();
+
+            const Node &node = nodes[candidate.node];
+
+            if (isLeaf(candidate.node))
+            {
+                if (!callback({node.component, node.body, candidate.distance}))
+                    return;
+
+                continue;
+            }
+
+            push(node.left);
+            push(node.right);
+        }
+    }
+
+#pragma endregion
+
+#pragma region Tree
+
+    int PhysicsWorld::allocateNode()
+    {
+        if (freeList == -1)
+        {
+            nodes.emplace_back();
+            return (int) nodes.size() - 1;
+        }
+
+        int index = freeList;
+        freeList = nodes[index].parent;
+        nodes[index] = Node();
+        return index;
+    }
+
+    void PhysicsWorld::freeNode(int index)
+    {
+        nodes[index] = Node();
+        nodes[index].parent = freeList; // free nodes link through their parent
+        freeList = index;
+    }
+
+    void PhysicsWorld::insertLeaf(int leaf)
+    {
+        if (root == -1)
+        {
+            root = leaf;
+            nodes[root].parent = -1;
+            return;
+        }
+
+        // find the best sibling, using the perimeter as the cost of a box (the 2D surface area heuristic)
+        AABB leafBox = nodes[leaf].box;
+        int index = root;
+        while (!isLeaf(index))
+        {
+            int left = nodes[index].left;
+            int right = nodes[index].right;
+
+            float area = perimeter(nodes[index].box);
+            float combinedArea = perimeter(combine(nodes[index].box, leafBox));
+
+            // cost of creating a new parent for this node and the new leaf
+            float cost = 2.0f * combinedArea;
+
+            // minimum cost of pushing the leaf further down the tree
+            float inheritanceCost = 2.0f * (combinedArea - area);
+
+            auto descendCost = [&](int child)
+            {
+                float childCost = perimeter(combine(leafBox, nodes[child].box));
+                if (!isLeaf(child))
+                    childCost -= perimeter(nodes[child].box);
+
+                return childCost + inheritanceCost;
+            };
+
+            float leftCost = descendCost(left);
+            float rightCost = descendCost(right);
+
+            if (cost < leftCost && cost < rightCost)
+                break;
+
+            index = leftCost < rightCost ? left : right;
+        }
+
+        int sibling = index;
+        int oldParent = nodes[sibling].parent;
+        int newParent = allocateNode();
+
+        nodes[newParent].parent = oldParent;
+        nodes[newParent].box = combine(leafBox, nodes[sibling].box);
+        nodes[newParent].height = nodes[sibling].height + 1;
+        nodes[newParent].left = sibling;
+        nodes[newParent].right = leaf;
+        nodes[sibling].parent = newParent;
+        nodes[leaf].parent = newParent;
+
+        if (oldParent == -1)
+            root = newParent;
+        else if (nodes[oldParent].left == sibling)
+            nodes[oldParent].left = newParent;
+        else
+            nodes[oldParent].right = newParent;
+
+        refitAncestors(nodes[leaf].parent);
+    }
+
+    void PhysicsWorld::removeLeaf(int leaf)
+    {
+        if (leaf == root)
+        {
+            root = -1;
+            return;
+        }
+
+        int parent = nodes[leaf].parent;
+        int grandParent = nodes[parent].parent;
+        int sibling = nodes[parent].left == leaf ? nodes[parent].right : nodes[parent].left;
+
+        if (grandParent == -1)
+        {
+            root = sibling;
+            nodes[sibling].parent = -1;
+            freeNode(parent);
+        }
+        else
+        {
+            if (nodes[grandParent].left == parent)
+                nodes[grandParent].left = sibling;
+            else
+                nodes[grandParent].right = sibling;
+
+            nodes[sibling].parent = grandParent;
+            freeNode(parent);
+
+            refitAncestors(grandParent);
+        }
+
+        nodes[leaf].parent = -1;
+    }
+
+    void PhysicsWorld::refitAncestors(int index)
+    {
+        while (index != -1)
+        {
+            index = balance(index);
+
+            int left = nodes[index].left;
+            int right = nodes[index].right;
+
+            nodes[index].height = 1 + std::max(nodes[left].height, nodes[right].height);
+            nodes[index].box = combine(nodes[left].box, nodes[right].box);
+
+            index = nodes[index].parent;
+        }
+    }
+
+    int PhysicsWorld::balance(int a)
+    {
+        if (isLeaf(a) || nodes[a].height < 2)
+            return a;
+
+        int b = nodes[a].left;
+        int c = nodes[a].right;
+        int difference = nodes[c].height - nodes[b].height;
+
+        // promote the taller child, and give its shorter grandchild to a
+        if (difference > 1 || difference < -1)
+        {
+            int up = difference > 1 ? c : b; // the child that gets promoted
+            int other = difference > 1 ? b : c; // the child that stays with a
+            int f = nodes[up].left;
+            int g = nodes[up].right;
+
+            nodes[up].left = a;
+            nodes[up].parent = nodes[a].parent;
+            nodes[a].parent = up;
+
+            if (nodes[up].parent == -1)
+                root = up;
+            else if (nodes[nodes[up].parent].left == a)
+                nodes[nodes[up].parent].left = up;
+            else
+                nodes[nodes[up].parent].right = up;
+
+            int keep = nodes[f].height > nodes[g].height ? f : g; // stays with up
+            int give = keep == f ? g : f; // moves to a
+
+            nodes[up].right = keep;
+            if (difference > 1)
+                nodes[a].right = give;
+            else
+                nodes[a].left = give;
+            nodes[give].parent = a;
+
+            nodes[a].box = combine(nodes[other].box, nodes[give].box);
+            nodes[a].height = 1 + std::max(nodes[other].height, nodes[give].height);
+            nodes[up].box = combine(nodes[a].box, nodes[keep].box);
+            nodes[up].height = 1 + std::max(nodes[a].height, nodes[keep].height);
+
+            return up;
+        }
+
+        return a;
+    }
+
+#pragma endregion
+
+#pragma region AABB helpers
+
+    PhysicsWorld::AABB PhysicsWorld::toAABB(const SDL_Rect &rect)
+    {
+        return {(float) rect.x, (float) rect.y, (float) (rect.x + rect.w), (float) (rect.y + rect.h)};
+    }
+
+    PhysicsWorld::AABB PhysicsWorld::fatten(const AABB &box)
+    {
+        return {box.minX - FAT_MARGIN, box.minY - FAT_MARGIN, box.maxX + FAT_MARGIN, box.maxY + FAT_MARGIN};
+    }
+
+    PhysicsWorld::AABB PhysicsWorld::combine(const AABB &a, const AABB &b)
+    {
+        return {std::min(a.minX, b.minX), std::min(a.minY, b.minY), std::max(a.maxX, b.maxX), std::max(a.maxY, b.maxY)};
+    }
+
+    bool PhysicsWorld::contains(const AABB &outer, const AABB &inner)
+    {
+        return outer.minX <= inner.minX && outer.minY <= inner.minY && inner.maxX <= outer.maxX && inner.maxY <= outer.maxY;
+    }
+
+    float PhysicsWorld::perimeter(const AABB &box)
+    {
+        return 2.0f * ((box.maxX - box.minX) + (box.maxY - box.minY));
+    }
+
+#pragma endregion
+
+} // fruitwork
@@ -0,0 +1,214 @@
+#include "Profiler.h"
+#include <cstdio>
+#include <unordered_map>
+
+#ifdef __GNUG__
+#include <cxxabi.h>
+#include <cstdlib>
+#endif
+
+namespace fruitwork
+{
+    /**
+     * Turns a mangled type name into a readable one, e.g. "N9fruitwork6SpriteE" into "fruitwork::Sprite".
+     * @see https://gcc.gnu.org/onlinedocs/libstdc++/manual/ext_demangling.html
+     */
+    static std::string demangle(const char *name)
+    {
+#ifdef __GNUG__
+        int status = 0;
+        char *demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+        if (status == 0 && demangled != nullptr)
+        {
+            std::string result = demangled;
+            std::free(demangled);
+            return result;
+        }
+#endif
+        return name;
+    }
+
+    /** Escapes a string for use in a JSON string literal. */
+    static std::string escapeJson(const std::string &s)
+    {
+        std::string result;
+        result.reserve(s.size());
+
+        for (char c: s)
+        {
+            if (c == '"' || c == '\\')
+                result += '\\';
+
+            if ((unsigned char) c < 0x20)
+                result += ' ';
+            else
+                result += c;
+        }
+
+        return result;
+    }
+
+    void Profiler::start()
+    {
+        // the thread that starts the capture is the main thread, unless told otherwise
+        ThreadBuffer *startingThread = getThreadBuffer();
+        if (startingThread->threadName.empty())
+            startingThread->threadName = "Main thread";
+
+        std::lock_guard<std::mutex> lock(buffersMutex);
+
+        for (ThreadBuffer *buffer: buffers)
+        {
+            buffer->events.clear();
+            buffer->dropped = 0;
+        }
+
+        captureStart = SDL_GetPerformanceCounter();
+        recording.store(true);
+    }
+
+    void Profiler::stop()
+    {
+        recording.store(false);
+    }
+
+    Profiler::ThreadBuffer *Profiler::getThreadBuffer()
+    {
+        thread_local ThreadBuffer *threadBuffer = nullptr;
+
+        if (threadBuffer == nullptr)
+        {
+            threadBuffer = new ThreadBuffer();
+            threadBuffer->threadId = SDL_ThreadID();
+            threadBuffer->events.reserve(4096);
+
+            std::lock_guard<std::mutex> lock(buffersMutex);
+            buffers.push_back(threadBuffer);
+        }
+
+        return threadBuffer;
+    }
+
+    void Profiler::record(const Event &event)
+    {
+        ThreadBuffer *buffer = getThreadBuffer();
+
+        if (buffer->events.size() >= MAX_EVENTS_PER_THREAD)
+        {
+            buffer->dropped++;
+            return;
+        }
+
+        buffer->events.push_back(event);
+    }
+
+    void Profiler::zone(const char *name, Uint64 start, Uint64 end, bool isTypeName)
+    {
+        record({name, isTypeName ? EventType::TYPE_ZONE : EventType::ZONE, start, end - start, 0});
+    }
+
+    void Profiler::counter(const char *name, double value)
+    {
+        record({name, EventType::COUNTER, SDL_GetPerformanceCounter(), 0, value});
+    }
+
+    void Profiler::setThreadName(const std::string &name)
+    {
+        getThreadBuffer()->threadName = name;
+    }
+
+    bool Profiler::writeTrace(const std::string &path) const
+    {
+        FILE *file = std::fopen(path.c_str(), "w");
+        if (file == nullptr)
+        {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Unable to open %s for writing", path.c_str());
+            return false;
+        }
+
+        // trace timestamps are in microseconds
+        const double ticksToMicroseconds = 1000000.0 / SDL_GetPerformanceFrequency();
+
+        // every type name is demangled once, not once per event
+        std::unordered_map<const char *, std::string> typeNames;
+
+        std::lock_guard<std::mutex> lock(buffersMutex);
+
+        std::fprintf(file, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+        bool first = true;
+
+        for (const ThreadBuffer *buffer: buffers)
+        {
+            unsigned long tid = buffer->threadId;
+
+            if (!buffer->threadName.empty())
+            {
+                std::fprintf(file, "%s{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %lu, \"args\": {\"name\": \"%s\"}}",
+                             first ? "" : ",\n", tid, escapeJson(buffer->threadName).c_str());
+                first = false;
+            }
+
+            for (const Event &event: buffer->events)
+            {
+                // events recorded before the capture started belong to zones that were already open
+                double timestamp = event.start >= captureStart ? (event.start - captureStart) * ticksToMicroseconds : 0;
+
+                switch (event.type)
+                {
+                    case EventType::ZONE:
+                    case EventType::TYPE_ZONE:
+                    {
+                        std::string name;
+                        if (event.type == EventType::TYPE_ZONE)
+                        {
+                            auto it = typeNames.find(event.name);
+                            if (it == typeNames.end())
+                                it = typeNames.emplace(event.name, escapeJson(demangle(event.name))).first;
+
+                            name = it->second;
+                        }
+                        else
+                        {
+                            name = escapeJson(event.name);
+                        }
+
+                        std::fprintf(file, "%s{\"name\": \"%s\", \"ph\": \"X\", \"pid\": 1, \"tid\": %lu, \"ts\": %.3f, \"dur\": %.3f}",
+                                     first ? "" : ",\n", name.c_str(), tid, timestamp, event.duration * ticksToMicroseconds);
+                        break;
+                    }
+
+                    case EventType::COUNTER:
+                    {
+                        std::fprintf(file, "%s{\"name\": \"%s\", \"ph\": \"C\", \"pid\": 1, \"tid\": %lu, \"ts\": %.3f, \"args\": {\"value\": %g}}",
+                                     first ? "" : ",\n", escapeJson(event.name).c_str(), tid, timestamp, event.value);
+                        break;
+                    }
+                }
+
+                first = false;
+            }
+
+            if (buffer->dropped > 0)
+                SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Profiler dropped %llu events on thread %lu, the capture was too long",
+                            (unsigned long long) buffer->dropped, tid);
+        }
+
+        std::fprintf(file, "\n]}\n");
+        std::fclose(file);
+
+        SDL_Log("Trace written to %s", path.c_str());
+
+        return true;
+    }
+
+    Profiler::~Profiler()
+    {
+        for (ThreadBuffer *buffer: buffers)
+            delete buffer;
+    }
+
+    Profiler Profiler::instance;
+
+    std::atomic<bool> Profiler::recording(false);
+
+} // fruitwork
@@ -1,5 +1,6 @@
+#include <cmath>
+#include <algorithm>
 #include "Rectangle.h"
-#include "System.h"
 
 namespace fruitwork
 {
@@ -10,52 +11,40 @@ namespace fruitwork
 
     fruitwork::Rectangle::Rectangle(int x, int y, int w, int h, SDL_Color c) : Shape(x, y, w, h, c) {}
 
-    void fruitwork::Rectangle::draw() const
+    void Rectangle::setCornerRadius(int r)
     {
-        if (getAbsoluteAngle() == 0.0) // use the old way
-            drawNormal();
-        else
-            drawRotated();
-    }
-
-    void Rectangle::drawNormal() const
-    {
-        SDL_Renderer *renderer = sys.getRenderer();
-
-        SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
-        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND); // respect alpha
-        SDL_RenderFillRect(renderer, &getAbsoluteRect());
+        if (cornerRadius == r)
+            return;
 
-        // reset
-        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+        cornerRadius = r;
+        invalidateGeometry();
     }
 
-    void Rectangle::drawRotated() const
+    void Rectangle::buildOutline(int w, int h, std::vector<SDL_FPoint> &outline) const
     {
-        SDL_Renderer *renderer = sys.getRenderer();
-        SDL_Rect absRect = getAbsoluteRect();
-        double angle = getAbsoluteAngle();
-        SDL_Point pivot = getPixelPivot();
-
-        SDL_Texture *texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888,
-                                                 SDL_TEXTUREACCESS_TARGET, absRect.w, absRect.h);
-
-        // render to texture
-        SDL_SetRenderTarget(renderer, texture);
-        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND); // respect alpha
-        SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
-        SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
-        SDL_RenderClear(renderer);
-
-        // draw rectangle to screen
-        SDL_SetRenderTarget(renderer, nullptr);
-        SDL_RenderCopyEx(renderer, texture, nullptr, &absRect, -angle, &pivot, getFlip());
-
-        // reset
-        SDL_DestroyTexture(texture);
-        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+        auto width = (float) w, height = (float) h;
+        float r = std::min((float) cornerRadius, std::min(width, height) / 2);
+
+        if (r <= 0)
+        {
+            outline = {{0, 0}, {width, 0}, {width, height}, {0, height}};
+            return;
+        }
+
+        // a quarter circle around the center of every corner, clockwise from the top left
+        const SDL_FPoint centers[4] = {{r, r}, {width - r, r}, {width - r, height - r}, {r, height - r}};
+        int segments = std::max(2, std::min(16, (int) r / 2));
+
+        for (int corner = 0; corner < 4; corner++)
+        {
+            double start = M_PI + corner * M_PI / 2;
+
+            for (int i = 0; i <= segments; i++)
+            {
+                double angle = start + i * M_PI / 2 / segments;
+                outline.push_back({centers[corner].x + r * (float) std::cos(angle), centers[corner].y + r * (float) std::sin(angle)});
+            }
+        }
     }
 
-} // fruitwork
\ No newline at end of file
+} // fruitwork
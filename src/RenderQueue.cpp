@@ -0,0 +1,130 @@
+#include <cmath>
+#include <utility>
+#include "RenderQueue.h"
+#include "System.h"
+#include "Profiler.h"
+
+namespace fruitwork
+{
+    RenderQueue RenderQueue::instance;
+
+    void RenderQueue::submit(SDL_Texture *texture, const SDL_Rect *source, const SDL_Rect &destination, double angle,
+                             const SDL_Point *center, SDL_RendererFlip flip, SDL_Color color)
+    {
+        useTexture(texture);
+
+        // texture coordinates, flipping swaps them
+        SDL_Rect s = source != nullptr ? *source : SDL_Rect{0, 0, batchTextureSize.x, batchTextureSize.y};
+        float u0 = (float) s.x / batchTextureSize.x, u1 = (float) (s.x + s.w) / batchTextureSize.x;
+        float v0 = (float) s.y / batchTextureSize.y, v1 = (float) (s.y + s.h) / batchTextureSize.y;
+
+        if (flip & SDL_FLIP_HORIZONTAL)
+            std::swap(u0, u1);
+
+        if (flip & SDL_FLIP_VERTICAL)
+            std::swap(v0, v1);
+
+        float w = (float) destination.w, h = (float) destination.h;
+        float centerX = center != nullptr ? (float) center->x : w / 2;
+        float centerY = center != nullptr ? (float) center->y : h / 2;
+
+        // corners relative to the center of rotation: top left, top right, bottom right, bottom left
+        SDL_FPoint corners[4] = {{-centerX,     -centerY},
+                                 {w - centerX,  -centerY},
+                                 {w - centerX,  h - centerY},
+                                 {-centerX,     h - centerY}};
+        SDL_FPoint texCoords[4] = {{u0, v0}, {u1, v0}, {u1, v1}, {u0, v1}};
+
+        float cosAngle = 1, sinAngle = 0;
+        if (angle != 0)
+        {
+            double radians = angle * M_PI / 180.0;
+            cosAngle = (float) std::cos(radians);
+            sinAngle = (float) std::sin(radians);
+        }
+
+        float originX = destination.x + centerX, originY = destination.y + centerY;
+
+        int first = (int) vertices.size();
+        for (int i = 0; i < 4; i++)
+        {
+            // y points down, so a positive angle rotates clockwise like SDL_RenderCopyEx
+            SDL_FPoint position = {originX + corners[i].x * cosAngle - corners[i].y * sinAngle,
+                                   originY + corners[i].x * sinAngle + corners[i].y * cosAngle};
+            vertices.push_back({position, color, texCoords[i]});
+        }
+
+        indices.insert(indices.end(), {first, first + 1, first + 2, first, first + 2, first + 3});
+    }
+
+    SDL_Vertex *RenderQueue::reserve(SDL_Texture *texture, int vertexCount, const int *meshIndices, int indexCount)
+    {
+        useTexture(texture);
+
+        int first = (int) vertices.size();
+        vertices.resize(vertices.size() + vertexCount);
+
+        for (int i = 0; i < indexCount; i++)
+            indices.push_back(first + meshIndices[i]);
+
+        return vertices.data() + first;
+    }
+
+    SDL_Vertex *RenderQueue::reserveQuads(SDL_Texture *texture, int quadCount)
+    {
+        useTexture(texture);
+
+        int first = (int) vertices.size();
+        vertices.resize(vertices.size() + quadCount * 4);
+        indices.reserve(indices.size() + quadCount * 6);
+
+        for (int quad = first; quad < first + quadCount * 4; quad += 4)
+            indices.insert(indices.end(), {quad, quad + 1, quad + 2, quad, quad + 2, quad + 3});
+
+        return vertices.data() + first;
+    }
+
+    void RenderQueue::useTexture(SDL_Texture *texture)
+    {
+        if (texture == batchTexture && !vertices.empty())
+            return;
+
+        flush();
+
+        batchTexture = texture;
+        batchTextureSize = {1, 1};
+        if (texture != nullptr)
+            SDL_QueryTexture(texture, nullptr, nullptr, &batchTextureSize.x, &batchTextureSize.y);
+    }
+
+    void RenderQueue::flush()
+    {
+        if (vertices.empty())
+            return;
+
+        FRUITWORK_PROFILE_ZONE("RenderQueue::flush");
+
+        SDL_Renderer *renderer = sys.getRenderer();
+
+        if (batchTexture != nullptr)
+        {
+            // colors are per vertex, a modulation left on the texture would be applied on top of them
+            SDL_SetTextureColorMod(batchTexture, 255, 255, 255);
+            SDL_SetTextureAlphaMod(batchTexture, 255);
+            SDL_RenderGeometry(renderer, batchTexture, vertices.data(), (int) vertices.size(), indices.data(), (int) indices.size());
+        }
+        else
+        {
+            // untextured quads use the draw blend mode, respect alpha
+            SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+            SDL_RenderGeometry(renderer, nullptr, vertices.data(), (int) vertices.size(), indices.data(), (int) indices.size());
+            SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+        }
+
+        drawCalls++;
+
+        vertices.clear();
+        indices.clear();
+    }
+
+} // fruitwork
@@ -2,22 +2,45 @@
 #include "ResourceManager.h"
 #include <sys/stat.h>
 #include <string>
+#include <algorithm>
 #include "SDL.h"
+#include <SDL_image.h>
+#include "System.h"
+#include "Profiler.h"
+#include "GlyphAtlas.h"
+#include "AssetArchive.h"
 
 namespace fruitwork
 {
     /**
-     * Checks if a file exists at the given path.
+     * Checks if a file exists at the given path, in the asset archive or on disk.
      * @param path The path to check.
      * @return True if the file exists, false otherwise.
      * @see https://stackoverflow.com/a/12774387
      */
     inline bool file_exists(const std::string &path)
     {
+        if (AssetArchive::getInstance()->contains(path))
+            return true;
+
         struct stat buffer{};
         return (stat(path.c_str(), &buffer) == 0);
     }
 
+    bool ResourceManager::exists(const std::string &path)
+    {
+        return file_exists(path);
+    }
+
+    SDL_RWops *ResourceManager::openFile(const std::string &path)
+    {
+        SDL_RWops *file = AssetArchive::getInstance()->open(path);
+        if (file != nullptr)
+            return file;
+
+        return SDL_RWFromFile(path.c_str(), "rb");
+    }
+
     /**
      * Get the relative path to a texture file.
      * @param textureName the name of the texture file, including the extension. it will be assumed to be in the images directory, but subdirectories can be specified (e.g. "subdir/texture.png")
@@ -25,6 +48,7 @@ namespace fruitwork
      */
     std::string ResourceManager::getTexturePath(const std::string &textureName)
     {
+        FRUITWORK_PROFILE_ZONE("ResourceManager::getTexturePath");
         std::string path = constants::gResPath + "images/" + textureName;
 
         if (textureName.find("{n}") == std::string::npos && !file_exists(path))
@@ -35,6 +59,7 @@ namespace fruitwork
 
     std::string ResourceManager::getFontPath(const std::string &fontName)
     {
+        FRUITWORK_PROFILE_ZONE("ResourceManager::getFontPath");
         bool hasExtension = fontName.find(".ttf") != std::string::npos;
 
         std::string path = constants::gResPath + "fonts/" + fontName + (hasExtension ? "" : ".ttf");
@@ -46,6 +71,7 @@ namespace fruitwork
 
     std::string ResourceManager::getAudioPath(const std::string &clipName)
     {
+        FRUITWORK_PROFILE_ZONE("ResourceManager::getAudioPath");
         std::string path = constants::gResPath + "sounds/" + clipName;
         if (!file_exists(path))
             SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to find audio clip at path: %s", clipName.c_str());
@@ -53,5 +79,266 @@ namespace fruitwork
         return path;
     }
 
+    /** Erase the entries of a cache whose resource no one holds anymore, the resource itself is freed already. */
+    template<typename T>
+    static void eraseExpired(std::unordered_map<std::string, std::weak_ptr<T>> &cache)
+    {
+        for (auto it = cache.begin(); it != cache.end();)
+        {
+            if (it->second.expired())
+                it = cache.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    ResourceManager::TextureHandle ResourceManager::getTexture(const std::string &path)
+    {
+        TextureHandle texture = findTexture(path);
+        if (texture != nullptr)
+            return texture;
+
+        FRUITWORK_PROFILE_ZONE("ResourceManager: load texture");
+
+        // don't decode the image again if its pixels are already loaded
+        SDL_Texture *loaded;
+        auto cachedSurface = surfaces.find(path);
+        SurfaceHandle surface = cachedSurface != surfaces.end() ? cachedSurface->second.lock() : nullptr;
+        if (surface != nullptr)
+            loaded = SDL_CreateTextureFromSurface(sys.getRenderer(), surface.get());
+        else
+            loaded = IMG_LoadTexture_RW(sys.getRenderer(), openFile(path), 1);
+
+        if (loaded == nullptr)
+        {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to load texture %s: %s", path.c_str(), IMG_GetError());
+            return nullptr;
+        }
+
+        // only cached once loaded, so failed paths don't leave entries behind
+        texture = TextureHandle(loaded, SDL_DestroyTexture);
+        textures[path] = texture;
+
+        return texture;
+    }
+
+    ResourceManager::TextureHandle ResourceManager::findTexture(const std::string &path)
+    {
+        auto cached = textures.find(path);
+        return cached != textures.end() ? cached->second.lock() : nullptr;
+    }
+
+    ResourceManager::TextureHandle ResourceManager::addTexture(const std::string &path, SDL_Surface *surface)
+    {
+        TextureHandle texture = findTexture(path);
+        if (texture != nullptr)
+            return texture;
+
+        FRUITWORK_PROFILE_ZONE("ResourceManager: upload texture");
+
+        SDL_Texture *created = SDL_CreateTextureFromSurface(sys.getRenderer(), surface);
+        if (created == nullptr)
+        {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create texture %s: %s", path.c_str(), SDL_GetError());
+            return nullptr;
+        }
+
+        texture = TextureHandle(created, SDL_DestroyTexture);
+        textures[path] = texture;
+
+        return texture;
+    }
+
+    ResourceManager::SurfaceHandle ResourceManager::getSurface(const std::string &path)
+    {
+        auto cached = surfaces.find(path);
+        SurfaceHandle surface = cached != surfaces.end() ? cached->second.lock() : nullptr;
+        if (surface != nullptr)
+            return surface;
+
+        FRUITWORK_PROFILE_ZONE("ResourceManager: load surface");
+
+        SDL_Surface *loaded = IMG_Load_RW(openFile(path), 1);
+        if (loaded == nullptr)
+        {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to load image %s: %s", path.c_str(), IMG_GetError());
+            return nullptr;
+        }
+
+        surface = SurfaceHandle(loaded, SDL_FreeSurface);
+        surfaces[path] = surface;
+
+        return surface;
+    }
+
+    void ResourceManager::releaseUnusedTextures()
+    {
+        eraseExpired(textures);
+        eraseExpired(surfaces);
+    }
+
+    int ResourceManager::getLoadedTextureCount()
+    {
+        int count = 0;
+        for (auto &entry: textures)
+        {
+            if (!entry.second.expired())
+                count++;
+        }
+
+        return count;
+    }
+
+    /**
+     * Open fonts by path, size and style, and the fonts kept open until the next scene change.
+     * Created on first use and never destroyed: System opens its font during static initialization and closes it during static destruction.
+     */
+    struct FontCache {
+        std::unordered_map<std::string, std::weak_ptr<TTF_Font>> fonts;
+        std::vector<ResourceManager::FontHandle> retained;
+    };
+
+    static FontCache &getFontCache()
+    {
+        static auto *cache = new FontCache();
+        return *cache;
+    }
+
+    ResourceManager::FontHandle ResourceManager::getFont(const std::string &path, int size, int style)
+    {
+        FontCache &cache = getFontCache();
+        std::string key = path + '|' + std::to_string(size) + '|' + std::to_string(style);
+
+        auto cached = cache.fonts.find(key);
+        FontHandle font = cached != cache.fonts.end() ? cached->second.lock() : nullptr;
+        if (font != nullptr)
+        {
+            // keep it open for the rest of the scene, also if it was opened during the previous one
+            if (std::find(cache.retained.begin(), cache.retained.end(), font) == cache.retained.end())
+                cache.retained.push_back(font);
+
+            return font;
+        }
+
+        FRUITWORK_PROFILE_ZONE("ResourceManager: open font");
+
+        // the stream is read for as long as the font is open, and closed with it
+        TTF_Font *opened = TTF_OpenFontRW(openFile(path), 1, size);
+        if (opened == nullptr)
+        {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to open font %s: %s", path.c_str(), TTF_GetError());
+            return nullptr;
+        }
+
+        TTF_SetFontStyle(opened, style);
+
+        // the glyphs rasterized from the font go with it
+        font = FontHandle(opened, [](TTF_Font *f)
+        {
+            GlyphAtlas::release(f);
+            TTF_CloseFont(f);
+        });
+
+        // only cached once open, so fonts that failed to open don't leave entries behind
+        cache.fonts[key] = font;
+        cache.retained.push_back(font);
+
+        return font;
+    }
+
+    void ResourceManager::releaseUnusedFonts()
+    {
+        FontCache &cache = getFontCache();
+        cache.retained.clear();
+        eraseExpired(cache.fonts);
+    }
+
+    int ResourceManager::getOpenFontCount()
+    {
+        int count = 0;
+        for (auto &entry: getFontCache().fonts)
+        {
+            if (!entry.second.expired())
+                count++;
+        }
+
+        return count;
+    }
+
+    /**
+     * Loaded sounds by path, and the sounds kept loaded when no one holds them.
+     * Created on first use and never destroyed: System releases the sounds during static destruction.
+     */
+    struct SoundCache {
+        std::unordered_map<std::string, std::weak_ptr<Mix_Chunk>> sounds;
+        std::vector<ResourceManager::SoundHandle> retained;
+    };
+
+    static SoundCache &getSoundCache()
+    {
+        static auto *cache = new SoundCache();
+        return *cache;
+    }
+
+    ResourceManager::SoundHandle ResourceManager::getSound(const std::string &path)
+    {
+        SoundHandle sound = findSound(path);
+        if (sound != nullptr)
+            return sound;
+
+        FRUITWORK_PROFILE_ZONE("ResourceManager: load sound");
+
+        // SDL_mixer converts the samples to the format of the device opened by System while loading, so playing is a plain mix
+        Mix_Chunk *loaded = Mix_LoadWAV_RW(openFile(path), 1);
+        if (loaded == nullptr)
+        {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to load sound %s: %s", path.c_str(), Mix_GetError());
+            return nullptr;
+        }
+
+        return addSound(path, SoundHandle(loaded, Mix_FreeChunk));
+    }
+
+    ResourceManager::SoundHandle ResourceManager::findSound(const std::string &path)
+    {
+        SoundCache &cache = getSoundCache();
+        auto cached = cache.sounds.find(path);
+        return cached != cache.sounds.end() ? cached->second.lock() : nullptr;
+    }
+
+    ResourceManager::SoundHandle ResourceManager::addSound(const std::string &path, const SoundHandle &sound)
+    {
+        SoundHandle existing = findSound(path);
+        if (existing != nullptr || sound == nullptr)
+            return existing;
+
+        SoundCache &cache = getSoundCache();
+        cache.sounds[path] = sound;
+        cache.retained.push_back(sound);
+
+        return sound;
+    }
+
+    void ResourceManager::releaseUnusedSounds()
+    {
+        SoundCache &cache = getSoundCache();
+        cache.retained.clear();
+        eraseExpired(cache.sounds);
+    }
+
+    int ResourceManager::getLoadedSoundCount()
+    {
+        int count = 0;
+        for (auto &entry: getSoundCache().sounds)
+        {
+            if (!entry.second.expired())
+                count++;
+        }
+
+        return count;
+    }
+
+    std::unordered_map<std::string, std::weak_ptr<SDL_Texture>> ResourceManager::textures;
+    std::unordered_map<std::string, std::weak_ptr<SDL_Surface>> ResourceManager::surfaces;
 
 } // fruitwork
\ No newline at end of file
@@ -13,12 +13,25 @@ namespace fruitwork
         return new ResponsiveSprite(x, y, w, h, texture, alignment);
     }
 
+    ResponsiveSprite *ResponsiveSprite::getInstance(int x, int y, int w, int h, const TextureAtlas::Region &region, Alignment alignment)
+    {
+        return new ResponsiveSprite(x, y, w, h, region, alignment);
+    }
+
+    ResponsiveSprite *ResponsiveSprite::getAtlasInstance(int x, int y, int w, int h, const std::string &imageName, Alignment alignment)
+    {
+        return new ResponsiveSprite(x, y, w, h, TextureAtlas::getImage(imageName), alignment);
+    }
+
     ResponsiveSprite::ResponsiveSprite(int x, int y, int w, int h, const std::string &texturePath, Alignment alignment)
             : Sprite(x, y, w, h, texturePath), alignment(alignment), originalRect({x, y, w, h}) {}
 
     ResponsiveSprite::ResponsiveSprite(int x, int y, int w, int h, SDL_Texture *texture, Alignment alignment)
             : Sprite(x, y, w, h, texture), alignment(alignment), originalRect({x, y, w, h}) {}
 
+    ResponsiveSprite::ResponsiveSprite(int x, int y, int w, int h, const TextureAtlas::Region &region, Alignment alignment)
+            : Sprite(x, y, w, h, region), alignment(alignment), originalRect({x, y, w, h}) {}
+
     void ResponsiveSprite::start()
     {
         updateRect();
@@ -36,13 +49,19 @@ namespace fruitwork
         updateRect();
     }
 
+    void ResponsiveSprite::setRegion(const TextureAtlas::Region &region)
+    {
+        Sprite::setRegion(region);
+        updateRect();
+    }
+
     void ResponsiveSprite::updateRect()
     {
         SDL_Rect r = originalRect;
 
         // the sprites needs to be downscaled to fit within their rect r, while keeping their aspect ratio
-        int w, h;
-        SDL_QueryTexture(spriteTexture, nullptr, nullptr, &w, &h);
+        SDL_Point size = getImageSize();
+        int w = size.x, h = size.y;
 
         // calculate the scale factor
         double scale = std::min((double) r.w / w, (double) r.h / h);
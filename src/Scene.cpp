@@ -1,35 +1,196 @@
 #include "Scene.h"
 #include "Component.h"
 #include "DebugInfo.h"
+#include "Profiler.h"
 #include <algorithm>
 
 namespace fruitwork
 {
 
-    void Scene::addComponent(Component *component)
+    ComponentHandle Scene::addComponent(Component *component)
     {
-        components.push_back(component);
+        // re-added in the same frame it keeps its handle, a component of another scene gets none
+        if (!registerComponent(component))
+            return component->container == this ? getHandle(component) : ComponentHandle();
 
-        // sort components by z-index
-        // stable_sort is slower than sort, but it keeps the order of components with the same z-index intact
+        if (iterationDepth > 0)
+            componentsToAdd.push_back(component);
+        else
+            insertComponent(component);
+
+        return getHandle(component);
+    }
+
+    void Scene::addComponents(const std::vector<Component *> &newComponents)
+    {
+        std::vector<Component *> toInsert;
+        toInsert.reserve(newComponents.size());
+
+        for (Component *component: newComponents)
+        {
+            if (registerComponent(component))
+                toInsert.push_back(component);
+        }
+
+        if (iterationDepth > 0)
+            componentsToAdd.insert(componentsToAdd.end(), toInsert.begin(), toInsert.end());
+        else
+            insertComponents(toInsert);
+    }
+
+    void Scene::insertComponent(Component *component)
+    {
+        sortComponents(); // binary search needs an ordered list
+        Component::insertByZIndex(components, component);
+
+        component->start();
+    }
+
+    void Scene::insertComponents(const std::vector<Component *> &newComponents)
+    {
+        sortComponents();
+
+        // sort only the new components, then merge both ordered ranges
+        // stable_sort and inplace_merge keep the order of components with the same z-index intact
         // @see https://stackoverflow.com/a/34668459/11420970
-        std::stable_sort(components.begin(), components.end(), [](Component *a, Component *b)
+        auto middle = components.insert(components.end(), newComponents.begin(), newComponents.end());
+        auto byZIndex = [](const Component *a, const Component *b)
         {
             return a->zIndex() < b->zIndex();
-        });
+        };
 
-        component->start();
+        std::stable_sort(middle, components.end(), byZIndex);
+        std::inplace_merge(components.begin(), middle, components.end(), byZIndex);
+
+        for (Component *component: newComponents)
+            component->start();
     }
 
-    void Scene::addComponent(Component *component, int zIndex)
+    void Scene::sortComponents()
+    {
+        if (iterationDepth > 0 || sortedZIndexGeneration == Component::getZIndexGeneration())
+            return;
+
+        FRUITWORK_PROFILE_ZONE("Scene::sortComponents");
+        Component::sortByZIndex(components);
+        sortedZIndexGeneration = Component::getZIndexGeneration();
+    }
+
+    ComponentHandle Scene::addComponent(Component *component, int zIndex)
     {
         component->setZIndex(zIndex);
-        addComponent(component);
+        return addComponent(component);
+    }
+
+    void Scene::endIteration()
+    {
+        iterationDepth--;
+
+        if (iterationDepth > 0 || componentsToAdd.empty())
+            return;
+
+        std::vector<Component *> added;
+        added.swap(componentsToAdd);
+
+        // components removed while they were waiting are not started or inserted
+        added.erase(std::remove_if(added.begin(), added.end(), [this](const Component *c)
+        {
+            return c->container != this;
+        }), added.end());
+
+        insertComponents(added);
+    }
+
+    bool Scene::registerComponent(Component *component)
+    {
+        if (component->sceneSlot >= 0 || component->container != nullptr)
+        {
+            SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Component has already been added to a scene or the session.");
+            return false;
+        }
+
+        Uint32 index;
+        if (freeSlots.empty())
+        {
+            index = slots.size();
+            slots.emplace_back();
+        }
+        else
+        {
+            index = freeSlots.back();
+            freeSlots.pop_back();
+        }
+
+        slots[index].component = component;
+        component->sceneSlot = (int) index;
+        component->container = this;
+
+        // removed from this scene and re-added in the same frame, it never left the list
+        if (removedComponents.count(component) > 0)
+            return false;
+
+        return true;
+    }
+
+    void Scene::releaseSlot(Component *component)
+    {
+        Slot &slot = slots[component->sceneSlot];
+        slot.component = nullptr;
+
+        // invalidates every handle to this slot, generation 0 is reserved for null handles
+        if (++slot.generation == 0)
+            slot.generation = 1;
+
+        freeSlots.push_back(component->sceneSlot);
+        component->sceneSlot = -1;
+    }
+
+    Component *Scene::resolve(ComponentHandle handle) const
+    {
+        if (handle.isNull() || handle.index >= slots.size() || slots[handle.index].generation != handle.generation)
+            return nullptr;
+
+        return slots[handle.index].component;
+    }
+
+    ComponentHandle Scene::getHandle(const Component *component) const
+    {
+        if (component->sceneSlot < 0 || (size_t) component->sceneSlot >= slots.size() || slots[component->sceneSlot].component != component)
+            return {};
+
+        return {(Uint32) component->sceneSlot, slots[component->sceneSlot].generation};
     }
 
     void Scene::removeComponent(Component *component, bool destroy)
     {
-        componentsToDelete.push_back({component, destroy});
+        if (component->container != this)
+            return; // not in this scene, or already queued
+
+        // tombstone it, the list is compacted once at the end of the frame
+        component->container = nullptr;
+
+        if (component->sceneSlot >= 0 && (size_t) component->sceneSlot < slots.size() && slots[component->sceneSlot].component == component)
+            releaseSlot(component);
+
+        if (removedComponents.insert(component).second)
+        {
+            componentsToDelete.push_back({component, destroy});
+            return;
+        }
+
+        // removed, re-added and removed again in the same frame, it is queued already
+        for (auto &componentDelete: componentsToDelete)
+        {
+            if (componentDelete.component == component)
+                componentDelete.destroy = destroy;
+        }
+    }
+
+    void Scene::removeComponent(ComponentHandle handle, bool destroy)
+    {
+        Component *component = resolve(handle);
+        if (component != nullptr)
+            removeComponent(component, destroy);
     }
 
     void Scene::deleteComponents()
@@ -37,20 +198,36 @@ namespace fruitwork
         if (componentsToDelete.empty())
             return;
 
-        SDL_Log("Deleting %d components", (int)componentsToDelete.size());
+        FRUITWORK_PROFILE_ZONE("Scene::deleteComponents");
+
+        // drop all tombstoned components in a single pass
+        // every component in the list that doesn't belong to this scene anymore was removed from it
+        components.erase(std::remove_if(components.begin(), components.end(), [this](const Component *c)
+        {
+            return c->container != this;
+        }), components.end());
+
+        // and so was every component still waiting to be inserted that doesn't, it must not be inserted once deleted
+        componentsToAdd.erase(std::remove_if(componentsToAdd.begin(), componentsToAdd.end(), [this](const Component *c)
+        {
+            return c->container != this;
+        }), componentsToAdd.end());
 
         for (auto &componentDelete : componentsToDelete)
         {
-            auto it = std::find(components.begin(), components.end(), componentDelete.component);
+            Component *component = componentDelete.component;
+            if (component->container == this)
+                continue; // re-added after being removed
 
-            if (it != components.end())
-                components.erase(it);
+            physicsWorld.removeBody(component->getPhysicsBody());
 
-            if (componentDelete.destroy)
-                delete componentDelete.component;
+            // a component added to another scene or the session in the meantime lives on there
+            if (componentDelete.destroy && component->container == nullptr)
+                delete component;
         }
 
         componentsToDelete.clear();
+        removedComponents.clear();
     }
 
     // CLion has a bug where it marks bool = !bool; as unreachable, so I'm using this to suppress the warning
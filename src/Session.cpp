@@ -3,37 +3,122 @@
 #include "Session.h"
 #include "System.h"
 #include "Constants.h"
+#include "Profiler.h"
+#include "ResourceManager.h"
+#include "RenderQueue.h"
+#include "AssetLoader.h"
+#include "CollisionMask.h"
+#include "AnimationClip.h"
 #include <algorithm>
+#include <cmath>
 
 namespace fruitwork
 {
     void Session::addComponent(Component *component)
     {
-        components.push_back(component);
-
         if (component->getPhysicsBody() != nullptr)
             SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Session components will not have their physics bodies updated. Use Scene components instead.");
 
-        std::stable_sort(components.begin(), components.end(), [](Component *a, Component *b)
+        if (component->container != nullptr)
         {
-            return a->zIndex() < b->zIndex();
-        });
+            SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Component has already been added to a scene or the session.");
+            return;
+        }
+
+        component->container = this;
+
+        // removed from the session and re-added in the same frame, it never left the list
+        if (removedComponents.count(component) > 0)
+            return;
+
+        sortComponents(); // binary search needs an ordered list
+        Component::insertByZIndex(components, component);
 
         component->start();
     }
 
+    void Session::addComponents(const std::vector<Component *> &newComponents)
+    {
+        std::vector<Component *> toInsert;
+        toInsert.reserve(newComponents.size());
+
+        for (Component *component: newComponents)
+        {
+            if (component->getPhysicsBody() != nullptr)
+                SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Session components will not have their physics bodies updated. Use Scene components instead.");
+
+            if (component->container != nullptr)
+            {
+                SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Component has already been added to a scene or the session.");
+                continue;
+            }
+
+            component->container = this;
+
+            // removed from the session and re-added in the same frame, it never left the list
+            if (removedComponents.count(component) == 0)
+                toInsert.push_back(component);
+        }
+
+        sortComponents();
+
+        // sort only the new components, then merge both ordered ranges
+        auto middle = components.insert(components.end(), toInsert.begin(), toInsert.end());
+        auto byZIndex = [](const Component *a, const Component *b)
+        {
+            return a->zIndex() < b->zIndex();
+        };
+
+        std::stable_sort(middle, components.end(), byZIndex);
+        std::inplace_merge(components.begin(), middle, components.end(), byZIndex);
+
+        for (Component *component: toInsert)
+            component->start();
+    }
+
+    void Session::sortComponents()
+    {
+        if (sortedZIndexGeneration == Component::getZIndexGeneration())
+            return;
+
+        FRUITWORK_PROFILE_ZONE("Session::sortComponents");
+        Component::sortByZIndex(components);
+        sortedZIndexGeneration = Component::getZIndexGeneration();
+    }
+
     void Session::run(Scene *startScene)
     {
         bool running = true;
 
+        Scene *previousScene = sys.getCurrentScene();
         sys.setNextScene(startScene);
         sys.changeScene();
 
-        const int tickInterval = 1000 / constants::gFps;
+        // the session may be run again after it ended, clean up what the previous run left behind
+        if (previousScene != nullptr && previousScene != sys.getCurrentScene())
+            previousScene->deleteComponents();
+
+        const Uint64 frequency = SDL_GetPerformanceFrequency();
+        const Uint64 frameInterval = frequency / constants::gFps;
+
+        auto secondsBetween = [frequency](Uint64 from, Uint64 to)
+        {
+            return (float) (to - from) / frequency;
+        };
+
+        Uint64 lastFrameStart = SDL_GetPerformanceCounter();
+        float accumulator = 0;
+        int frame = 0;
 
         while (running)
         {
-            Uint32 nextTick = SDL_GetTicks() + tickInterval;
+            Uint64 frameStart = SDL_GetPerformanceCounter();
+            Uint64 nextFrame = frameStart + frameInterval;
+
+            frameTime = framePacing ? secondsBetween(lastFrameStart, frameStart) : elapsedTime;
+            lastFrameStart = frameStart;
+            accumulator += frameTime;
+
             SDL_Event event;
 
             while (SDL_PollEvent(&event))
@@ -46,6 +131,24 @@ namespace fruitwork
                         break;
                     }
 
+                    case SDL_APP_LOWMEMORY:
+                    {
+                        ResourceManager::releaseUnusedFonts();
+                        ResourceManager::releaseUnusedSounds();
+                        ResourceManager::releaseUnusedTextures();
+                        CollisionMask::releaseUnused();
+                        AnimationClip::releaseUnused();
+                        break;
+                    }
+
+                    case SDL_WINDOWEVENT:
+                    {
+                        if (event.window.event == SDL_WINDOWEVENT_SIZE_CHANGED)
+                            sys.onWindowResized();
+
+                        break;
+                    }
+
                     case SDL_MOUSEBUTTONDOWN:
                     {
                         for (auto component: components)
@@ -68,6 +171,17 @@ namespace fruitwork
                         break;
                     }
 
+                    case SDL_MOUSEWHEEL:
+                    {
+                        for (auto component: components)
+                            component->onMouseWheel(event);
+
+                        for (auto component: sys.getCurrentScene()->getComponents())
+                            component->onMouseWheel(event);
+
+                        break;
+                    }
+
                     case SDL_TEXTINPUT:
                     {
                         for (auto component: components)
@@ -122,63 +236,134 @@ namespace fruitwork
                 sys.getCurrentScene()->handleEvent(event);
             } // while event
 
-            elapsedTime = (float) (nextTick - SDL_GetTicks()) / 1000;
+            Uint64 eventsEnd = SDL_GetPerformanceCounter();
+
+            // create the textures of assets decoded in the background, within the frame budget
+            AssetLoader::getInstance()->update();
 
             // update session components
             for (Component *component: components)
+            {
+                FRUITWORK_PROFILE_TYPE_ZONE(*component);
                 component->update();
+            }
 
             // update scene
             sys.getCurrentScene()->update();
-            for (int i = 0; i < sys.getCurrentScene()->getComponents().size(); i++)
+            for (Component *component: sys.getCurrentScene()->getComponents())
             {
-                Component *component = sys.getCurrentScene()->getComponents()[i];
+                FRUITWORK_PROFILE_TYPE_ZONE(*component);
                 component->update();
-                component->update(elapsedTime);
+            }
 
-                // go through all components and check for physics collisions
-                // todo: optimize this, its worst case is O(n^2) (assuming all comps have bodies). maybe store a list of components with physics bodies?
-                PhysicsBody *bodyA = component->getPhysicsBody();
-                if (bodyA != nullptr && bodyA->getObjCollision())
-                {
-                    for (int j = 0; j < sys.getCurrentScene()->getComponents().size(); j++)
-                    {
-                        Component *other = sys.getCurrentScene()->getComponents()[j];
-                        PhysicsBody *bodyB = other->getPhysicsBody();
+            Uint64 updateEnd = SDL_GetPerformanceCounter();
 
-                        if (i != j && bodyB != nullptr && bodyB->getObjCollision() && bodyA->isColliding(bodyB))
-                        {
-                            bodyA->resolveCollision(bodyB);
-                        }
-                    }
-                }
+            // step the simulation at a fixed rate, as many times as needed to catch up with real time
+            int substeps = 0;
+            while (accumulator >= elapsedTime && substeps < maxSubsteps)
+            {
+                step(sys.getCurrentScene());
+                accumulator -= elapsedTime;
+                substeps++;
             }
 
+            // too far behind, drop the backlog instead of spending every following frame catching up
+            if (accumulator >= elapsedTime)
+                accumulator = std::fmod(accumulator, elapsedTime);
+
+            interpolationAlpha = accumulator / elapsedTime;
+            for (Component *component: sys.getCurrentScene()->getComponents())
+                component->interpolate(interpolationAlpha);
+
+            Uint64 physicsEnd = SDL_GetPerformanceCounter();
+
             auto oldScene = sys.getCurrentScene();
             sys.changeScene();
 
+            Uint64 drawStart = SDL_GetPerformanceCounter();
+
             SDL_SetRenderDrawColor(fruitwork::sys.getRenderer(), 255, 255, 255, 255);
             SDL_RenderClear(fruitwork::sys.getRenderer());
 
+            RenderQueue *renderQueue = RenderQueue::getInstance();
+            renderQueue->beginFrame();
+
             // draw scene
             sys.getCurrentScene()->draw();
             for (Component *component: sys.getCurrentScene()->getComponents())
+            {
+                FRUITWORK_PROFILE_TYPE_ZONE(*component);
+                if (!component->isDrawBatched())
+                    renderQueue->flush();
                 component->draw();
+            }
 
             // draw session components
             for (Component *component: components)
+            {
+                FRUITWORK_PROFILE_TYPE_ZONE(*component);
+                if (!component->isDrawBatched())
+                    renderQueue->flush();
                 component->draw();
+            }
+
+            renderQueue->flush();
+
+            Uint64 drawEnd = SDL_GetPerformanceCounter();
 
             // delete components marked for deletion
             oldScene->deleteComponents();
             this->deleteComponents();
 
+            // apply z-index changes made during the frame
+            sys.getCurrentScene()->sortComponents();
+            this->sortComponents();
+
+            Uint64 presentStart = SDL_GetPerformanceCounter();
+
             SDL_RenderPresent(fruitwork::sys.getRenderer());
 
-            int delay = nextTick - SDL_GetTicks();
-            if (delay > 0)
+            Uint64 now = SDL_GetPerformanceCounter();
+
+            frameTimings.events = secondsBetween(frameStart, eventsEnd);
+            frameTimings.update = secondsBetween(eventsEnd, updateEnd) + secondsBetween(physicsEnd, drawStart) + secondsBetween(drawEnd, presentStart);
+            frameTimings.physics = secondsBetween(updateEnd, physicsEnd);
+            frameTimings.draw = secondsBetween(drawStart, drawEnd);
+            frameTimings.present = secondsBetween(presentStart, now);
+
+            if (frameListener)
+                frameListener(frameTimings);
+
+#ifdef FRUITWORK_PROFILING
+            // the phases are already timed, record them as zones instead of timing them twice
+            if (Profiler::isRecording())
+            {
+                Profiler *profiler = Profiler::getInstance();
+                profiler->zone("Frame", frameStart, now);
+                profiler->zone("Events", frameStart, eventsEnd);
+                profiler->zone("Update", eventsEnd, updateEnd);
+                profiler->zone("Physics", updateEnd, physicsEnd);
+                profiler->zone("Change scene", physicsEnd, drawStart);
+                profiler->zone("Draw", drawStart, drawEnd);
+                profiler->zone("Delete and sort components", drawEnd, presentStart);
+                profiler->zone("Present", presentStart, now);
+                profiler->counter("Scene components", sys.getCurrentScene()->getComponents().size());
+                profiler->counter("Draw calls", renderQueue->getDrawCallCount());
+                profiler->counter("Substeps", substeps);
+            }
+#endif
+
+            if (frameLimit > 0 && ++frame >= frameLimit)
+                running = false;
+
+            // sleep for whole milliseconds, then spin the remainder for an exact frame time
+            if (framePacing && now < nextFrame)
             {
-                SDL_Delay(delay);
+                Uint32 delay = (Uint32) ((nextFrame - now) * 1000 / frequency);
+                if (delay > 1)
+                    SDL_Delay(delay - 1);
+
+                while (SDL_GetPerformanceCounter() < nextFrame);
             }
 
         } // while running
@@ -187,6 +372,43 @@ namespace fruitwork
                   std::endl;
     }
 
+    void Session::step(Scene *scene)
+    {
+        FRUITWORK_PROFILE_ZONE("Simulation step");
+        ComponentView sceneComponents = scene->getComponents();
+
+        for (Component *component: sceneComponents)
+        {
+            FRUITWORK_PROFILE_TYPE_ZONE(*component);
+            component->update(elapsedTime);
+        }
+
+        {
+            FRUITWORK_PROFILE_ZONE("PhysicsWorld::sync");
+            scene->getPhysicsWorld().sync(sceneComponents);
+        }
+
+        // resolve collisions between physics bodies, each overlapping pair once
+        FRUITWORK_PROFILE_ZONE("Broadphase");
+        Broadphase &broadphase = scene->getBroadphase();
+        broadphase.rebuild(sceneComponents);
+
+        for (const Broadphase::Pair &pair: broadphase.findPairs())
+            pair.a->resolveCollision(pair.b);
+    }
+
+    void Session::setSimulationRate(int hz)
+    {
+        if (hz <= 0)
+        {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Invalid simulation rate: %d", hz);
+            return;
+        }
+
+        simulationRate = hz;
+        elapsedTime = 1.0f / hz;
+    }
+
     Session::~Session()
     {
         std::cout << "Session destructor" << std::endl;
@@ -201,23 +423,51 @@ namespace fruitwork
 
     void Session::removeComponent(Component *component, bool destroy)
     {
-        componentsToDelete.push_back({component, destroy});
+        if (component->container != this)
+            return; // not in the session, or already queued
+
+        component->container = nullptr;
+
+        if (removedComponents.insert(component).second)
+        {
+            componentsToDelete.push_back({component, destroy});
+            return;
+        }
+
+        // removed, re-added and removed again in the same frame, it is queued already
+        for (auto &componentDelete: componentsToDelete)
+        {
+            if (componentDelete.component == component)
+                componentDelete.destroy = destroy;
+        }
     }
 
     void Session::deleteComponents()
     {
-        for (auto &componentDelete: componentsToDelete)
+        if (componentsToDelete.empty())
+            return;
+
+        FRUITWORK_PROFILE_ZONE("Session::deleteComponents");
+
+        // drop all tombstoned components in a single pass
+        // every component in the list that doesn't belong to the session anymore was removed from it
+        components.erase(std::remove_if(components.begin(), components.end(), [this](const Component *c)
         {
-            auto it = std::find(components.begin(), components.end(), componentDelete.component);
+            return c->container != this;
+        }), components.end());
 
-            if (it != components.end())
-                components.erase(it);
+        for (auto &componentDelete: componentsToDelete)
+        {
+            if (componentDelete.component->container == this)
+                continue; // re-added after being removed
 
-            if (componentDelete.destroy)
+            // a component added to a scene in the meantime lives on there
+            if (componentDelete.destroy && componentDelete.component->container == nullptr)
                 delete componentDelete.component;
         }
 
         componentsToDelete.clear();
+        removedComponents.clear();
     }
 
 } // fruitwork
\ No newline at end of file
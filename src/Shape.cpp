@@ -1,9 +1,131 @@
+#include <cmath>
+#include <algorithm>
 #include "Shape.h"
+#include "RenderQueue.h"
 
 namespace fruitwork
 {
+    /** How far an antialiased edge fades, in pixels. */
+    static const float FEATHER = 1;
+
+    /** How far a corner may stick out when it is offset for antialiasing, relative to the offset of its edges. */
+    static const float MITER_LIMIT = 4;
+
     Shape::Shape(int x, int y, int w, int h, SDL_Color c) : Component(x, y, w, h), color(c)
     {
     }
 
-} // fruitwork
\ No newline at end of file
+    void Shape::setColor(SDL_Color c)
+    {
+        if (c.r == color.r && c.g == color.g && c.b == color.b && c.a == color.a)
+            return;
+
+        color = c;
+        geometryDirty = true;
+    }
+
+    void Shape::setAntialiased(bool a)
+    {
+        if (antialiased == a)
+            return;
+
+        antialiased = a;
+        geometryDirty = true;
+    }
+
+    void Shape::draw() const
+    {
+        const SDL_Rect &rect = getAbsoluteRect();
+
+        if (geometryDirty || geometrySize.x != rect.w || geometrySize.y != rect.h)
+            buildGeometry(rect.w, rect.h);
+
+        if (vertices.empty())
+            return;
+
+        SDL_Vertex *out = RenderQueue::getInstance()->reserve(nullptr, (int) vertices.size(), indices.data(), (int) indices.size());
+
+        // rotate around the pivot, clockwise for a negative angle like the other components
+        SDL_Point pivot = getPixelPivot();
+        double radians = -getAbsoluteAngle() * M_PI / 180.0;
+        auto cosAngle = (float) std::cos(radians), sinAngle = (float) std::sin(radians);
+        float originX = (float) (rect.x + pivot.x), originY = (float) (rect.y + pivot.y);
+
+        for (size_t i = 0; i < vertices.size(); i++)
+        {
+            float x = vertices[i].position.x - (float) pivot.x, y = vertices[i].position.y - (float) pivot.y;
+
+            out[i] = vertices[i];
+            out[i].position = {originX + x * cosAngle - y * sinAngle, originY + x * sinAngle + y * cosAngle};
+        }
+    }
+
+    void Shape::buildGeometry(int w, int h) const
+    {
+        geometryDirty = false;
+        geometrySize = {w, h};
+        vertices.clear();
+        indices.clear();
+
+        std::vector<SDL_FPoint> outline;
+        buildOutline(w, h, outline);
+
+        int n = (int) outline.size();
+        if (n < 3)
+            return;
+
+        if (!antialiased)
+        {
+            for (const SDL_FPoint &point: outline)
+                vertices.push_back({point, color, {0, 0}});
+
+            // a convex polygon is a fan around any of its corners
+            for (int i = 1; i < n - 1; i++)
+                indices.insert(indices.end(), {0, i, i + 1});
+
+            return;
+        }
+
+        // an inner ring half a pixel inside the edge in the color, and an outer ring half a pixel outside it fully transparent
+        vertices.resize(n * 2);
+        SDL_Color transparent = {color.r, color.g, color.b, 0};
+
+        for (int i = 0; i < n; i++)
+        {
+            const SDL_FPoint &previous = outline[(i + n - 1) % n];
+            const SDL_FPoint &point = outline[i];
+            const SDL_FPoint &next = outline[(i + 1) % n];
+
+            // the outward normals of the edges before and after the corner, clockwise with y down
+            SDL_FPoint before = {point.y - previous.y, previous.x - point.x};
+            SDL_FPoint after = {next.y - point.y, point.x - next.x};
+
+            float beforeLength = std::sqrt(before.x * before.x + before.y * before.y);
+            float afterLength = std::sqrt(after.x * after.x + after.y * after.y);
+            before = beforeLength > 0 ? SDL_FPoint{before.x / beforeLength, before.y / beforeLength} : after;
+            after = afterLength > 0 ? SDL_FPoint{after.x / afterLength, after.y / afterLength} : before;
+
+            // offset the corner along the average normal, far enough that both edges move by the same distance
+            SDL_FPoint normal = {before.x + after.x, before.y + after.y};
+            float normalLength = std::sqrt(normal.x * normal.x + normal.y * normal.y);
+            if (normalLength > 0)
+                normal = {normal.x / normalLength, normal.y / normalLength};
+
+            float alignment = normal.x * after.x + normal.y * after.y;
+            float offset = FEATHER / 2 / std::max(alignment, 1 / MITER_LIMIT);
+
+            vertices[i] = {{point.x - normal.x * offset, point.y - normal.y * offset}, color, {0, 0}};
+            vertices[n + i] = {{point.x + normal.x * offset, point.y + normal.y * offset}, transparent, {0, 0}};
+        }
+
+        for (int i = 1; i < n - 1; i++)
+            indices.insert(indices.end(), {0, i, i + 1});
+
+        for (int i = 0; i < n; i++)
+        {
+            int j = (i + 1) % n;
+            indices.insert(indices.end(), {i, j, n + j, i, n + j, n + i});
+        }
+    }
+
+} // fruitwork
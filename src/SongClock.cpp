@@ -0,0 +1,172 @@
+#include <algorithm>
+#include <cstdlib>
+#include "SongClock.h"
+#include "ResourceManager.h"
+#include "Profiler.h"
+
+namespace fruitwork
+{
+    SongClock *SongClock::getInstance()
+    {
+        // read by the game and the mixer's callback thread, a function-local static is initialized exactly once
+        static SongClock *instance = new SongClock();
+        return instance;
+    }
+
+    bool SongClock::play(const std::string &path, int loops)
+    {
+        FRUITWORK_PROFILE_ZONE("SongClock::play");
+
+        stop();
+
+        // the music streams from the file while it plays, the stream is closed with it
+        Mix_Music *loaded = Mix_LoadMUS_RW(ResourceManager::openFile(path), 1);
+        if (loaded == nullptr)
+        {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to load song %s: %s", path.c_str(), Mix_GetError());
+            return false;
+        }
+
+        music = std::shared_ptr<Mix_Music>(loaded, Mix_FreeMusic);
+
+        int deviceFrequency, deviceChannels;
+        Uint16 deviceFormat;
+        if (Mix_QuerySpec(&deviceFrequency, &deviceFormat, &deviceChannels) == 0)
+        {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to play song %s, the audio device is not open: %s", path.c_str(), Mix_GetError());
+            music = nullptr;
+            return false;
+        }
+
+        Mix_SetPostMix(onPostMix, this);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            frequency = deviceFrequency;
+            frameSize = SDL_AUDIO_BITSIZE(deviceFormat) / 8 * deviceChannels;
+            mixedFrames = 0;
+            heardFrames = -(Sint64) bufferFrames;
+            callbackCounter = SDL_GetPerformanceCounter();
+            counting = true;
+
+            lastTime = heardFrames * 1000000 / frequency - outputLatency;
+        }
+
+        synced = false;
+
+        // nothing is counted until the mixer plays the music, so the callback can't count silence before this
+        if (Mix_PlayMusic(loaded, loops) == -1)
+        {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to play song %s: %s", path.c_str(), Mix_GetError());
+            stop();
+            return false;
+        }
+
+        return true;
+    }
+
+    void SongClock::pause()
+    {
+        // the callback stops counting once the mixer is paused
+        Mix_PauseMusic();
+    }
+
+    void SongClock::resume()
+    {
+        Mix_ResumeMusic();
+    }
+
+    void SongClock::stop()
+    {
+        // never call into the mixer while holding the mutex, the callback takes it while holding the mixer's lock
+        Mix_HaltMusic();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            counting = false;
+        }
+
+        music = nullptr;
+    }
+
+    bool SongClock::isPlaying() const
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!counting)
+                return false;
+        }
+
+        return Mix_PlayingMusic() && !Mix_PausedMusic();
+    }
+
+    Sint64 SongClock::getTime()
+    {
+        // frozen while paused or stopped, and caught up with the audio at once when it plays again
+        if (!isPlaying())
+        {
+            synced = false;
+            return lastTime;
+        }
+
+        Uint64 now = SDL_GetPerformanceCounter();
+        Sint64 audioTime;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            // the audio heard since the last callback, at most the buffer that was starting to play then
+            Sint64 bufferTime = (Sint64) bufferFrames * 1000000 / frequency;
+            Sint64 sinceCallback = now > callbackCounter ? getCounterTime(now - callbackCounter) : 0;
+            audioTime = heardFrames * 1000000 / frequency + std::min(sinceCallback, bufferTime);
+        }
+
+        Sint64 counterTime = getCounterTime(now);
+        Sint64 error = counterTime - audioTime - offset;
+
+        if (!synced || std::abs(error) > RESYNC_THRESHOLD)
+        {
+            offset = counterTime - audioTime;
+            synced = true;
+        }
+        else
+        {
+            offset += (Sint64) ((double) error * SMOOTHING);
+        }
+
+        lastTime = std::max(lastTime, counterTime - offset - outputLatency);
+        return lastTime;
+    }
+
+    void SongClock::onPostMix(void *clock, Uint8 *, int length)
+    {
+        auto *self = (SongClock *) clock;
+        Uint64 now = SDL_GetPerformanceCounter();
+
+        // the mixer's lock is held here and it is recursive, so asking it about the music is safe
+        bool musicMixed = Mix_PlayingMusic() && !Mix_PausedMusic();
+
+        std::lock_guard<std::mutex> lock(self->mutex);
+        if (self->frameSize == 0)
+            return;
+
+        Uint64 frames = (Uint64) length / self->frameSize;
+        self->bufferFrames = frames;
+
+        if (!self->counting || !musicMixed)
+            return;
+
+        // the buffer mixed before this one starts playing now, this one is heard after it
+        self->heardFrames = (Sint64) self->mixedFrames - (Sint64) frames;
+        self->mixedFrames += frames;
+        self->callbackCounter = now;
+    }
+
+    Sint64 SongClock::getCounterTime(Uint64 counter)
+    {
+        static const Uint64 counterFrequency = SDL_GetPerformanceFrequency();
+
+        // split, so counters of machines that have been up for a long time don't overflow
+        return (Sint64) (counter / counterFrequency * 1000000 + counter % counterFrequency * 1000000 / counterFrequency);
+    }
+
+} // fruitwork
@@ -1,30 +1,25 @@
+#include <cmath>
 #include "System.h"
 #include "Constants.h"
 #include "Sprite.h"
-
-#include <SDL_image.h>
+#include "Profiler.h"
+#include "ResourceManager.h"
+#include "RenderQueue.h"
 
 namespace fruitwork
 {
-    Sprite::Sprite(int x, int y, int w, int h, const std::string &texturePath, bool keepSurface) : Component(x, y, w, h), isTextureOwner(true)
+    Sprite::Sprite(int x, int y, int w, int h, const std::string &texturePath, bool keepSurface) : Component(x, y, w, h)
     {
-        surface = IMG_Load(texturePath.c_str());
-        spriteTexture = SDL_CreateTextureFromSurface(sys.getRenderer(), surface);
+        Sprite::setTexture(texturePath, keepSurface);
+    }
 
-        if (keepSurface)
-            SDL_SetTextureBlendMode(spriteTexture, SDL_BLENDMODE_BLEND);
-        else
-        {
-            SDL_FreeSurface(surface);
-            surface = nullptr;
-        }
+    Sprite::Sprite(int x, int y, int w, int h, SDL_Texture *texture) : Component(x, y, w, h), spriteTexture(texture) {}
 
-        if (spriteTexture == nullptr)
-            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to load texture: %s", SDL_GetError());
+    Sprite::Sprite(int x, int y, int w, int h, const TextureAtlas::Region &region) : Component(x, y, w, h)
+    {
+        Sprite::setRegion(region);
     }
 
-    Sprite::Sprite(int x, int y, int w, int h, SDL_Texture *texture) : Component(x, y, w, h), spriteTexture(texture), isTextureOwner(false) {}
-
     Sprite *Sprite::getInstance(int x, int y, int w, int h, const std::string &texturePath, bool keepSurface)
     {
         return new Sprite(x, y, w, h, texturePath, keepSurface);
@@ -35,88 +30,106 @@ namespace fruitwork
         return new Sprite(x, y, w, h, texture);
     }
 
+    Sprite *Sprite::getInstance(int x, int y, int w, int h, const TextureAtlas::Region &region)
+    {
+        return new Sprite(x, y, w, h, region);
+    }
+
+    Sprite *Sprite::getAtlasInstance(int x, int y, int w, int h, const std::string &imageName)
+    {
+        return new Sprite(x, y, w, h, TextureAtlas::getImage(imageName));
+    }
+
     void Sprite::draw() const
     {
         if (spriteTexture == nullptr)
             return;
 
-        SDL_SetTextureColorMod(spriteTexture, colorMod.r, colorMod.g, colorMod.b);
-        SDL_SetTextureAlphaMod(spriteTexture, alphaMod);
         SDL_Rect rect = getAbsoluteRect();
-//        SDL_Point *p = new SDL_Point();
-//        p->x = 250;
-//        p->y = 125;
-        SDL_RenderCopyEx(sys.getRenderer(), spriteTexture, nullptr, &rect, -getAngle(), nullptr, getFlip());
-    }
+        SDL_Color color = {colorMod.r, colorMod.g, colorMod.b, alphaMod};
 
-    Sprite::~Sprite()
-    {
-        if (isTextureOwner)
-            SDL_DestroyTexture(spriteTexture);
+        if (!isRegion)
+        {
+            RenderQueue::getInstance()->submit(spriteTexture, nullptr, rect, -getAngle(), nullptr, getFlip(), color);
+            return;
+        }
+
+        // the region is trimmed, place it where it was in the original image, scaled to the rect
+        float scaleX = (float) rect.w / region.originalWidth;
+        float scaleY = (float) rect.h / region.originalHeight;
 
-        if (isSurfaceOwner)
-            SDL_FreeSurface(surface);
+        SDL_RendererFlip flip = getFlip();
+        int offsetX = flip & SDL_FLIP_HORIZONTAL ? region.originalWidth - region.offset.x - region.source.w : region.offset.x;
+        int offsetY = flip & SDL_FLIP_VERTICAL ? region.originalHeight - region.offset.y - region.source.h : region.offset.y;
+
+        SDL_Rect destination = {rect.x + (int) std::lround(offsetX * scaleX), rect.y + (int) std::lround(offsetY * scaleY),
+                                (int) std::lround(region.source.w * scaleX), (int) std::lround(region.source.h * scaleY)};
+
+        // keep rotating around the center of the whole rect, not of the trimmed part
+        SDL_Point center = {rect.w / 2 - (destination.x - rect.x), rect.h / 2 - (destination.y - rect.y)};
+
+        RenderQueue::getInstance()->submit(spriteTexture, &region.source, destination, -getAngle(), &center, flip, color);
     }
 
     void fruitwork::Sprite::setTexture(const std::string &texturePath)
     {
-        if (isTextureOwner)
-            SDL_DestroyTexture(spriteTexture);
-
-        if (isSurfaceOwner)
-        {
-            SDL_FreeSurface(surface);
-            isSurfaceOwner = false;
-            surface = nullptr;
-        }
-
-        surface = IMG_Load(texturePath.c_str());
-        isTextureOwner = true;
+        Sprite::setTexture(texturePath, false);
     }
 
     void fruitwork::Sprite::setTexture(const std::string &texturePath, bool keepSurface)
     {
-        if (isTextureOwner)
-            SDL_DestroyTexture(spriteTexture);
-
-        if (isSurfaceOwner)
-        {
-            SDL_FreeSurface(surface);
-            isSurfaceOwner = false;
-            surface = nullptr;
-        }
+        // build the mask first, the texture is then created from the pixels it was built from instead of decoding the image twice
+        isRegion = false;
+        region = {};
+        this->texturePath = texturePath;
+        scaledCollisionMask = nullptr;
+
+        ResourceManager::SurfaceHandle surface = keepSurface ? ResourceManager::getSurface(texturePath) : nullptr;
+        collisionMask = keepSurface ? CollisionMask::getInstance(texturePath, 10) : nullptr; // the default threshold of pixelCollidesWith
+        textureHandle = ResourceManager::getTexture(texturePath);
+        spriteTexture = textureHandle.get();
+
+        if (keepSurface && spriteTexture != nullptr)
+            SDL_SetTextureBlendMode(spriteTexture, SDL_BLENDMODE_BLEND);
+    }
 
-        surface = IMG_Load(texturePath.c_str());
-        spriteTexture = SDL_CreateTextureFromSurface(sys.getRenderer(), surface);
+    void fruitwork::Sprite::setTexture(SDL_Texture *texture)
+    {
+        isRegion = false;
+        region = {};
+        textureHandle = nullptr;
+        texturePath.clear();
+        collisionMask = nullptr;
+        scaledCollisionMask = nullptr;
+        spriteTexture = texture;
+    }
 
-        isTextureOwner = true;
+    void Sprite::setRegion(const TextureAtlas::Region &atlasRegion)
+    {
+        isRegion = true;
+        region = atlasRegion;
+        textureHandle = region.page;
+        texturePath.clear();
+        collisionMask = nullptr;
+        scaledCollisionMask = nullptr;
+        spriteTexture = textureHandle.get();
+    }
 
-        if (keepSurface)
-        {
-            isSurfaceOwner = true;
-        }
-        else
-        {
-            SDL_FreeSurface(surface);
-            surface = nullptr;
-            isSurfaceOwner = false;
-        }
+    void Sprite::setRegion(const std::string &imageName)
+    {
+        setRegion(TextureAtlas::getImage(imageName));
     }
 
-    void fruitwork::Sprite::setTexture(SDL_Texture *texture)
+    SDL_Point Sprite::getImageSize() const
     {
-        if (isTextureOwner)
-            SDL_DestroyTexture(spriteTexture);
+        if (isRegion)
+            return {region.originalWidth, region.originalHeight};
 
-        if (isSurfaceOwner)
-        {
-            SDL_FreeSurface(surface);
-            isSurfaceOwner = false;
-            surface = nullptr;
-        }
+        SDL_Point size = {0, 0};
+        if (spriteTexture != nullptr)
+            SDL_QueryTexture(spriteTexture, nullptr, nullptr, &size.x, &size.y);
 
-        spriteTexture = texture;
-        isTextureOwner = false;
+        return size;
     }
 
 #pragma region Collision Detection
@@ -141,75 +154,55 @@ namespace fruitwork
         return true;
     }
 
-    inline static Uint32 getPixel(SDL_Surface *surface, int x, int y)
+    const CollisionMask *Sprite::getCollisionMask(Uint8 alpha) const
     {
-        SDL_LockSurface(surface);
-        int bpp = surface->format->BytesPerPixel;
-        Uint8 *p = (Uint8 *) surface->pixels + y * surface->pitch + x * bpp;
-        Uint32 pixel;
+        if (collisionMask == nullptr)
+            return nullptr;
 
-        switch (bpp) // NOLINT(hicpp-multiway-paths-covered) - a default case is not needed
+        // another threshold is another mask, built once and shared like the first
+        if (collisionMask->getAlpha() != alpha)
         {
-            case 1:
-                pixel = *p;
-                break;
-
-            case 2:
-                pixel = *(Uint16 *) p;
-                break;
-
-            case 3:
-                if (SDL_BYTEORDER == SDL_BIG_ENDIAN) // NOLINT
-                    pixel = p[0] << 16 | p[1] << 8 | p[2];
-                else
-                    pixel = p[0] | p[1] << 8 | p[2] << 16;
-                break;
-
-            case 4:
-                pixel = *(Uint32 *) p;
-                break;
+            CollisionMask::Handle mask = CollisionMask::getInstance(texturePath, alpha);
+            if (mask == nullptr)
+                return nullptr;
+
+            collisionMask = mask;
+            scaledCollisionMask = nullptr;
         }
 
-        SDL_UnlockSurface(surface);
-        return pixel;
+        const SDL_Rect &rect = getAbsoluteRect();
+        if (rect.w == collisionMask->width() && rect.h == collisionMask->height())
+            return collisionMask.get();
+
+        // scaled once, until the size of the sprite changes
+        if (scaledCollisionMask == nullptr || scaledCollisionMask->width() != rect.w || scaledCollisionMask->height() != rect.h)
+            scaledCollisionMask = collisionMask->scaled(rect.w, rect.h);
+
+        return scaledCollisionMask.get();
     }
 
     bool Sprite::pixelCollidesWith(const Sprite *other, Uint8 alpha) const
     {
-        if (surface == nullptr || other->surface == nullptr)
+        FRUITWORK_PROFILE_ZONE("Sprite::pixelCollidesWith");
+        if (collisionMask == nullptr || other->collisionMask == nullptr)
         {
-            SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Cannot check pixel collision with a sprite that has no surface. Returning false.");
+            SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Cannot check pixel collision with a sprite that has no collision mask. Returning false.");
             return false;
         }
 
-        SDL_Rect rect1 = getAbsoluteRect();
-        SDL_Rect rect2 = other->getAbsoluteRect();
-
         if (!rectCollidesWith(other))
             return false; // no point of trying if not even the rects collide
 
-        SDL_Rect intersection;
-        SDL_IntersectRect(&rect1, &rect2, &intersection);
+        const CollisionMask *mask1 = getCollisionMask(alpha);
+        const CollisionMask *mask2 = other->getCollisionMask(alpha);
 
-        for (int x = intersection.x; x < intersection.x + intersection.w; x++)
-        {
-            for (int y = intersection.y; y < intersection.y + intersection.h; y++)
-            {
-                Uint32 pixel1 = getPixel(surface, x - rect1.x, y - rect1.y);
-                Uint32 pixel2 = getPixel(other->surface, x - rect2.x, y - rect2.y);
-
-                Uint8 r1, g1, b1, a1;
-                Uint8 r2, g2, b2, a2;
-
-                SDL_GetRGBA(pixel1, surface->format, &r1, &g1, &b1, &a1);
-                SDL_GetRGBA(pixel2, other->surface->format, &r2, &g2, &b2, &a2);
+        if (mask1 == nullptr || mask2 == nullptr)
+            return false;
 
-                if (a1 > alpha && a2 > alpha)
-                    return true;
-            }
-        }
+        SDL_Rect rect1 = getAbsoluteRect();
+        SDL_Rect rect2 = other->getAbsoluteRect();
 
-        return false;
+        return CollisionMask::overlaps(*mask1, {rect1.x, rect1.y}, *mask2, {rect2.x, rect2.y});
     }
 
 #pragma endregion
@@ -4,6 +4,11 @@
 #include <SDL_image.h>
 #include "Constants.h"
 #include "ExitScene.h"
+#include "Profiler.h"
+#include "ResourceManager.h"
+#include "AssetLoader.h"
+#include "CollisionMask.h"
+#include "AnimationClip.h"
 
 namespace fruitwork
 {
@@ -22,6 +27,7 @@ namespace fruitwork
         Uint32 flags = SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE;
         window = SDL_CreateWindow("fruitwork", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, constants::gScreenWidth, constants::gScreenHeight, flags);
         renderer = SDL_CreateRenderer(window, -1, 0);
+        SDL_GetWindowSize(window, &windowSize.x, &windowSize.y);
 
         if (TTF_Init() != 0)
         {
@@ -33,7 +39,8 @@ namespace fruitwork
             SDL_Log("SDL_ttf initialized");
         }
 
-        font = TTF_OpenFont(constants::gDefaultFontPath.c_str(), 24);
+        fontHandle = ResourceManager::getFont(constants::gDefaultFontPath, 24);
+        font = fontHandle.get();
 
         if (font == nullptr)
             SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Unable to load font: %s", TTF_GetError());
@@ -52,13 +59,13 @@ namespace fruitwork
         }
 
         // set cursor
-        SDL_Surface *cursorSurface = IMG_Load((constants::gResPath + "cursors/normal.cur").c_str());
+        SDL_Surface *cursorSurface = IMG_Load_RW(ResourceManager::openFile(constants::gResPath + "cursors/normal.cur"), 1);
         cursorDefault = SDL_CreateColorCursor(cursorSurface, 0, 0);
 
-        SDL_Surface *pointerSurface = IMG_Load((constants::gResPath + "cursors/link.cur").c_str());
+        SDL_Surface *pointerSurface = IMG_Load_RW(ResourceManager::openFile(constants::gResPath + "cursors/link.cur"), 1);
         cursorPointer = SDL_CreateColorCursor(pointerSurface, 0, 0);
 
-        SDL_Surface *textSurface = IMG_Load((constants::gResPath + "cursors/text.cur").c_str());
+        SDL_Surface *textSurface = IMG_Load_RW(ResourceManager::openFile(constants::gResPath + "cursors/text.cur"), 1);
         cursorText = SDL_CreateColorCursor(textSurface, 0, 0);
 
         SDL_SetCursor(cursorDefault);
@@ -71,17 +78,29 @@ namespace fruitwork
     {
         SDL_Log("Shutting down System");
 
+        // the workers may still be decoding with SDL
+        AssetLoader::getInstance()->shutdown();
+
         SDL_FreeCursor(cursorDefault);
         SDL_FreeCursor(cursorPointer);
         SDL_FreeCursor(cursorText);
 
-        TTF_CloseFont(font);
+        // close every font before SDL_ttf shuts down, and free the sounds before the audio device goes
+        ResourceManager::releaseUnusedFonts();
+        ResourceManager::releaseUnusedSounds();
+        fontHandle = nullptr;
         TTF_Quit();
         SDL_DestroyRenderer(renderer);
         SDL_DestroyWindow(window);
         SDL_Quit();
     }
 
+    void System::onWindowResized()
+    {
+        SDL_GetWindowSize(window, &windowSize.x, &windowSize.y);
+        layoutGeneration++;
+    }
+
     void System::setNextScene(Scene *scene)
     {
         if (scene != ExitScene::getInstance())
@@ -96,9 +115,23 @@ namespace fruitwork
         SDL_Log("Changing scene...");
 
         if (currentScene != nullptr)
+        {
+            FRUITWORK_PROFILE_ZONE("Scene::exit");
+            FRUITWORK_PROFILE_TYPE_ZONE(*currentScene);
             currentScene->exit(); // unload current scene
+        }
+
+        // fonts only the previous scene used are closed once its components are deleted
+        ResourceManager::releaseUnusedFonts();
+        ResourceManager::releaseUnusedTextures();
+        CollisionMask::releaseUnused();
+        AnimationClip::releaseUnused();
 
-        nextScene->enter(); // load next scene
+        {
+            FRUITWORK_PROFILE_ZONE("Scene::enter");
+            FRUITWORK_PROFILE_TYPE_ZONE(*nextScene);
+            nextScene->enter(); // load next scene
+        }
 
         currentScene = nextScene;
         nextScene = nullptr;
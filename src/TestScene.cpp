@@ -73,7 +73,7 @@ namespace fruitwork
         sprite->setAngle(45);
 
         // not owner of the texture
-        SDL_Texture *texture = IMG_LoadTexture(sys.getRenderer(), ResourceManager::getTexturePath("button-middle.png").c_str());
+        SDL_Texture *texture = IMG_LoadTexture_RW(sys.getRenderer(), ResourceManager::openFile(ResourceManager::getTexturePath("button-middle.png")), 1);
         Sprite *responsiveSprite = ResponsiveSprite::getInstance(650, 650, 256, 128, texture);
 
         // sprites that are too tall
@@ -115,33 +115,35 @@ namespace fruitwork
                                          fruitwork::sys.setNextScene(fruitwork::TestSceneIndex::getInstance());
                                      });
 
-        addComponent(title);
+        addComponents({
+                title,
 
-        addComponent(smallButton);
-        addComponent(smallButton2);
-        addComponent(mediumButton);
-        addComponent(largeButton);
-        addComponent(tallButton);
+                smallButton,
+                smallButton2,
+                mediumButton,
+                largeButton,
+                tallButton,
 
-        addComponent(inputField);
-        addComponent(passwordInputField);
-        addComponent(numericInputField);
+                inputField,
+                passwordInputField,
+                numericInputField,
 
-        addComponent(leftAnchoredLabel);
-        addComponent(centerAnchoredLabel);
-        addComponent(rightAnchoredLabel);
+                leftAnchoredLabel,
+                centerAnchoredLabel,
+                rightAnchoredLabel,
 
-        addComponent(sprite);
-        addComponent(responsiveSprite);
-        addComponent(sprite2);
-        addComponent(responsiveSprite2);
+                sprite,
+                responsiveSprite,
+                sprite2,
+                responsiveSprite2,
 
-        addComponent(imageButton);
-        addComponent(imageButton2);
+                imageButton,
+                imageButton2,
 
-        addComponent(animatedSprite);
+                animatedSprite,
 
-        addComponent(returnButton);
+                returnButton
+        });
 
         return success;
     }
@@ -151,7 +153,7 @@ namespace fruitwork
         bool success = true;
         SDL_Log("Exiting TestScene...");
 
-        for (auto &c: components)
+        for (Component *c: getComponents())
             removeComponent(c, true);
 
         return success;
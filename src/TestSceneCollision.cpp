@@ -27,11 +27,13 @@ namespace fruitwork
         lynn = fruitwork::Sprite::getInstance(600, 200, 610, 648, fruitwork::ResourceManager::getTexturePath("fruit-catcher-kiai.png"), true);
         bananas = fruitwork::Sprite::getInstance(0, 0, 128, 128, fruitwork::ResourceManager::getTexturePath("fruit-bananas.png"), true);
 
-        addComponent(jerafina);
-        addComponent(lynn);
-        addComponent(bananas);
-        addComponent(titleText);
-        addComponent(returnButton);
+        addComponents({
+                jerafina,
+                lynn,
+                bananas,
+                titleText,
+                returnButton
+        });
 
         return true;
     }
@@ -91,7 +93,7 @@ namespace fruitwork
         bool success = true;
         SDL_Log("Exiting TestSceneIndex...");
 
-        for (auto &c : components)
+        for (Component *c: getComponents())
             removeComponent(c, true);
 
         return success;
@@ -51,16 +51,18 @@ namespace fruitwork
                                                  confettiCannonAnotherImage->fire(-90, 90, 100, 200);
                                              });
 
-        addComponent(titleText);
-        addComponent(returnButton);
+        addComponents({
+                titleText,
+                returnButton,
 
-        addComponent(confettiCannonCenter);
-        addComponent(confettiCannonRightCorner);
-        addComponent(confettiCannonAnotherImage);
+                confettiCannonCenter,
+                confettiCannonRightCorner,
+                confettiCannonAnotherImage,
 
-        addComponent(buttonCenter360);
-        addComponent(buttonRightTowardsCenter);
-        addComponent(buttonAnotherImage);
+                buttonCenter360,
+                buttonRightTowardsCenter,
+                buttonAnotherImage
+        });
 
         return true;
     }
@@ -70,7 +72,7 @@ namespace fruitwork
         bool success = true;
         SDL_Log("Exiting TestSceneConfetti...");
 
-        for (auto &c: components)
+        for (Component *c: getComponents())
             removeComponent(c, true);
 
         return success;
@@ -223,7 +223,7 @@ namespace fruitwork
         bool success = true;
         SDL_Log("Exiting TestSceneHierarchy...");
 
-        for (auto &c : components)
+        for (Component *c: getComponents())
             removeComponent(c, true);
 
         yuzu::ses.deregisterKeyboardEvent(SDLK_a);
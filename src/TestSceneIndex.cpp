@@ -55,14 +55,16 @@ namespace fruitwork
                                               });
 
 
-        addComponent(titleText);
-        addComponent(buttonButtonTests);
-        addComponent(buttonCollisionTests);
-        addComponent(buttonPhysicsTests);
-        addComponent(buttonHierarchyTests);
-        addComponent(buttonConfettiTests);
+        addComponents({
+                titleText,
+                buttonButtonTests,
+                buttonCollisionTests,
+                buttonPhysicsTests,
+                buttonHierarchyTests,
+                buttonConfettiTests,
 
-        addComponent(returnButton);
+                returnButton
+        });
 
         return true;
     }
@@ -72,7 +74,7 @@ namespace fruitwork
         bool success = true;
         SDL_Log("Exiting TestSceneIndex...");
 
-        for (auto &c: components)
+        for (Component *c: getComponents())
             removeComponent(c, true);
 
         return success;
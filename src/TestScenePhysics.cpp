@@ -156,7 +156,7 @@ namespace fruitwork
         bool success = true;
         SDL_Log("Exiting TestScenePhysics...");
 
-        for (auto &c : components)
+        for (Component *c: getComponents())
             removeComponent(c, true);
 
         return success;
@@ -0,0 +1,397 @@
+#include "TextArea.h"
+#include <algorithm>
+#include <cstring>
+#include "InputField.h"
+#include "System.h"
+#include "RenderQueue.h"
+
+namespace fruitwork
+{
+    /** The space between the border and the text. */
+    static const int PADDING = 10;
+
+    /** How many lines one step of the mouse wheel scrolls. */
+    static const int WHEEL_LINES = 3;
+
+    TextArea *TextArea::getInstance(int x, int y, int w, int h)
+    {
+        return new TextArea(x, y, w, h);
+    }
+
+    TextArea::TextArea(int x, int y, int w, int h) : Component(x, y, w, h)
+    {
+        lineHeight = sys.getFont() != nullptr ? std::max(1, TTF_FontLineSkip(sys.getFont())) : 1;
+    }
+
+    TextArea::~TextArea()
+    {
+        if (isFocused)
+            InputField::setListenerState(false);
+    }
+
+    void TextArea::draw() const
+    {
+        SDL_Rect rect = getAbsoluteRect();
+
+        const Uint8 shade = isFocused ? 240 : 255;
+        SDL_Rect innerRect = {rect.x + 1, rect.y + 1, rect.w - 2, rect.h - 2};
+
+        RenderQueue *queue = RenderQueue::getInstance();
+        queue->submit(nullptr, nullptr, rect, 0, nullptr, SDL_FLIP_NONE, {128, 128, 128, 255});
+        queue->submit(nullptr, nullptr, innerRect, 0, nullptr, SDL_FLIP_NONE, {shade, shade, shade, 255});
+
+        // long lines are cut off at the padding, the clip rect only applies to what is flushed while it is set
+        SDL_Rect textRect = {rect.x + PADDING, rect.y + PADDING, rect.w - 2 * PADDING, rect.h - 2 * PADDING};
+        queue->flush();
+        SDL_RenderSetClipRect(sys.getRenderer(), &textRect);
+
+        // the visible lines, including one cut off at the bottom
+        GlyphAtlas *atlas = GlyphAtlas::getInstance(sys.getFont());
+        int lastLine = std::min((int) lines.size(), scrollLine + getVisibleLineCount() + 1);
+
+        for (int i = scrollLine; i < lastLine; i++)
+        {
+            Line &line = lines[i];
+            if (line.dirty)
+            {
+                buffer.copy(lineStarts[i], getLineEnd(i) - lineStarts[i], lineText);
+                atlas->layout(lineText, line.layout);
+                line.dirty = false;
+            }
+
+            line.layout.draw({textRect.x, textRect.y + (i - scrollLine) * lineHeight}, {0, 0, 0, 255});
+        }
+
+        // draw caret
+        int caretLine = getLineAt(caretPosition);
+        if (caretVisible && isFocused && caretLine >= scrollLine && caretLine < lastLine)
+        {
+            SDL_Rect caretRect = {textRect.x + caretOffset, textRect.y + (caretLine - scrollLine) * lineHeight, 2, lineHeight};
+            queue->submit(nullptr, nullptr, caretRect, 0, nullptr, SDL_FLIP_NONE, {0, 0, 0, 255});
+        }
+
+        queue->flush();
+        SDL_RenderSetClipRect(sys.getRenderer(), nullptr);
+    }
+
+    void TextArea::update()
+    {
+        // update caret
+        caretBlinkCounter++;
+        if (caretBlinkCounter > CARET_BLINK_INTERVAL)
+        {
+            caretBlinkCounter = 0;
+            caretVisible = !caretVisible;
+        }
+
+        // update cursor
+        SDL_Point mousePos = {0, 0};
+        SDL_GetMouseState(&mousePos.x, &mousePos.y);
+
+        if (SDL_PointInRect(&mousePos, &getAbsoluteRect()))
+        {
+            isHovered = true;
+            SDL_SetCursor(sys.getCursorText());
+        }
+        else if (isHovered)
+        {
+            isHovered = false;
+            SDL_SetCursor(sys.getCursorDefault());
+        }
+    }
+
+    void TextArea::onMouseDown(const SDL_Event &)
+    {
+        SDL_Point mousePos;
+        SDL_GetMouseState(&mousePos.x, &mousePos.y);
+
+        const SDL_Rect &rect = getAbsoluteRect();
+        bool inRect = SDL_PointInRect(&mousePos, &rect);
+
+        if (inRect)
+        {
+            if (!isFocused)
+            {
+                isFocused = true;
+                InputField::setListenerState(true);
+            }
+
+            int line = scrollLine + (mousePos.y - rect.y - PADDING) / lineHeight;
+            line = std::max(0, std::min(line, getLineCount() - 1));
+
+            moveCaret(getPositionInLine(line, mousePos.x - rect.x - PADDING));
+        }
+        else if (isFocused)
+        {
+            isFocused = false;
+            InputField::setListenerState(false);
+        }
+    }
+
+    void TextArea::onMouseWheel(const SDL_Event &event)
+    {
+        if (!isHovered)
+            return;
+
+        scrollLine -= event.wheel.y * WHEEL_LINES;
+        clampScroll();
+    }
+
+    void TextArea::onTextInput(const SDL_Event &event)
+    {
+        if (!isFocused)
+            return;
+
+        size_t length = strlen(event.text.text);
+        insert(caretPosition, event.text.text, length);
+        moveCaret(caretPosition + length);
+    }
+
+    void TextArea::onKeyDown(const SDL_Event &event)
+    {
+        if (!isFocused)
+            return;
+
+        bool ctrl = (event.key.keysym.mod & KMOD_CTRL) != 0;
+        int line = getLineAt(caretPosition);
+
+        switch (event.key.keysym.sym)
+        {
+            case SDLK_BACKSPACE:
+                if (caretPosition > 0)
+                {
+                    size_t previous = getPreviousCharacter(caretPosition);
+                    erase(previous, caretPosition);
+                    moveCaret(previous);
+                }
+                break;
+
+            case SDLK_DELETE:
+                if (caretPosition < buffer.size())
+                {
+                    erase(caretPosition, getNextCharacter(caretPosition));
+                    moveCaret(caretPosition);
+                }
+                break;
+
+            case SDLK_RETURN:
+                insert(caretPosition, "\n", 1);
+                moveCaret(caretPosition + 1);
+                break;
+
+            case SDLK_ESCAPE:
+                InputField::setListenerState(false);
+                isFocused = false;
+                break;
+
+            case SDLK_LEFT:
+                moveCaret(getPreviousCharacter(caretPosition));
+                break;
+            case SDLK_RIGHT:
+                moveCaret(getNextCharacter(caretPosition));
+                break;
+            case SDLK_UP:
+                moveCaretLines(-1);
+                break;
+            case SDLK_DOWN:
+                moveCaretLines(1);
+                break;
+            case SDLK_PAGEUP:
+                moveCaretLines(-getVisibleLineCount());
+                break;
+            case SDLK_PAGEDOWN:
+                moveCaretLines(getVisibleLineCount());
+                break;
+            case SDLK_HOME:
+                moveCaret(ctrl ? 0 : lineStarts[line]);
+                break;
+            case SDLK_END:
+                moveCaret(ctrl ? buffer.size() : getLineEnd(line));
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    void TextArea::setText(const std::string &t)
+    {
+        buffer.clear();
+        lineStarts.assign(1, 0);
+        lines.assign(1, Line());
+
+        insert(0, t.data(), t.size());
+
+        scrollLine = 0;
+        moveCaret(0);
+    }
+
+    void TextArea::insert(size_t position, const char *text, size_t length)
+    {
+        int line = getLineAt(position);
+
+        buffer.insert(position, text, length);
+        lines[line].dirty = true;
+
+        for (size_t i = line + 1; i < lineStarts.size(); i++)
+            lineStarts[i] += length;
+
+        // every newline starts a line after the one the text was inserted into
+        size_t newLines = std::count(text, text + length, '\n');
+        if (newLines == 0)
+            return;
+
+        lineStarts.insert(lineStarts.begin() + line + 1, newLines, 0);
+        lines.insert(lines.begin() + line + 1, newLines, Line());
+
+        size_t next = line + 1;
+        for (size_t i = 0; i < length; i++)
+        {
+            if (text[i] == '\n')
+                lineStarts[next++] = position + i + 1;
+        }
+    }
+
+    void TextArea::erase(size_t from, size_t to)
+    {
+        if (to <= from)
+            return;
+
+        int line = getLineAt(from);
+
+        // the lines whose newline is erased merge into the line the erased text starts on
+        auto first = std::upper_bound(lineStarts.begin() + line + 1, lineStarts.end(), from);
+        auto last = std::upper_bound(first, lineStarts.end(), to);
+        auto mergedLines = last - first;
+
+        lineStarts.erase(first, last);
+        lines.erase(lines.begin() + line + 1, lines.begin() + line + 1 + mergedLines);
+
+        for (size_t i = line + 1; i < lineStarts.size(); i++)
+            lineStarts[i] -= to - from;
+
+        buffer.erase(from, to - from);
+        lines[line].dirty = true;
+
+        clampScroll();
+    }
+
+    int TextArea::getLineAt(size_t position) const
+    {
+        return (int) (std::upper_bound(lineStarts.begin(), lineStarts.end(), position) - lineStarts.begin()) - 1;
+    }
+
+    size_t TextArea::getLineEnd(int line) const
+    {
+        return line + 1 < getLineCount() ? lineStarts[line + 1] - 1 : buffer.size();
+    }
+
+    int TextArea::getOffsetInLine(int line, size_t position) const
+    {
+        buffer.copy(lineStarts[line], position - lineStarts[line], lineText);
+        return GlyphAtlas::getInstance(sys.getFont())->measure(lineText);
+    }
+
+    size_t TextArea::getPositionInLine(int line, int x) const
+    {
+        GlyphAtlas *atlas = GlyphAtlas::getInstance(sys.getFont());
+        buffer.copy(lineStarts[line], getLineEnd(line) - lineStarts[line], lineText);
+
+        // walk the advances until x, then pick whichever character boundary is closer
+        int offset = 0;
+        Uint32 previous = 0;
+        size_t index = 0;
+
+        while (index < lineText.size())
+        {
+            size_t start = index;
+            Uint32 codepoint = GlyphAtlas::decodeUtf8(lineText, index);
+            int advance = atlas->getAdvance(codepoint, previous);
+
+            if (x < offset + advance)
+                return lineStarts[line] + (x - offset <= offset + advance - x ? start : index);
+
+            offset += advance;
+            previous = codepoint;
+        }
+
+        return lineStarts[line] + lineText.size();
+    }
+
+    int TextArea::getVisibleLineCount() const
+    {
+        return std::max(1, (getAbsoluteRect().h - 2 * PADDING) / lineHeight);
+    }
+
+    void TextArea::clampScroll()
+    {
+        scrollLine = std::max(0, std::min(scrollLine, getLineCount() - getVisibleLineCount()));
+    }
+
+    void TextArea::moveCaret(size_t position, bool keepPreferredOffset)
+    {
+        caretPosition = std::min(position, buffer.size());
+
+        int line = getLineAt(caretPosition);
+        caretOffset = getOffsetInLine(line, caretPosition);
+
+        if (!keepPreferredOffset)
+            preferredOffset = -1;
+
+        // scroll the caret into view
+        if (line < scrollLine)
+            scrollLine = line;
+        else if (line >= scrollLine + getVisibleLineCount())
+            scrollLine = line - getVisibleLineCount() + 1;
+
+        caretBlinkCounter = 0;
+        caretVisible = true; // the caret is always visible when typing
+    }
+
+    void TextArea::moveCaretLines(int count)
+    {
+        int line = getLineAt(caretPosition) + count;
+
+        if (line < 0)
+        {
+            moveCaret(0);
+            return;
+        }
+
+        if (line >= getLineCount())
+        {
+            moveCaret(buffer.size());
+            return;
+        }
+
+        if (preferredOffset < 0)
+            preferredOffset = caretOffset;
+
+        moveCaret(getPositionInLine(line, preferredOffset), true);
+    }
+
+    size_t TextArea::getPreviousCharacter(size_t position) const
+    {
+        if (position == 0)
+            return 0;
+
+        position--;
+        while (position > 0 && (buffer[position] & 0xC0) == 0x80)
+            position--;
+
+        return position;
+    }
+
+    size_t TextArea::getNextCharacter(size_t position) const
+    {
+        if (position >= buffer.size())
+            return buffer.size();
+
+        position++;
+        while (position < buffer.size() && (buffer[position] & 0xC0) == 0x80)
+            position++;
+
+        return position;
+    }
+
+} // fruitwork
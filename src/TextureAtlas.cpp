@@ -0,0 +1,121 @@
+#include "TextureAtlas.h"
+#include <sstream>
+#include "Constants.h"
+#include "Profiler.h"
+
+namespace fruitwork
+{
+    TextureAtlas *TextureAtlas::getInstance()
+    {
+        // created and loaded exactly once, even if the first lookups come from several threads
+        static TextureAtlas *instance = create();
+        return instance;
+    }
+
+    TextureAtlas *TextureAtlas::create()
+    {
+        auto *atlas = new TextureAtlas();
+
+        std::string indexPath = constants::gResPath + "atlas/atlas.txt";
+        if (ResourceManager::exists(indexPath))
+            atlas->load(indexPath);
+        else
+            SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "No texture atlas at %s, images are loaded one by one. Run make atlas to build it.", indexPath.c_str());
+
+        return atlas;
+    }
+
+    TextureAtlas::Region TextureAtlas::getImage(const std::string &name)
+    {
+        const Region *region = getInstance()->getRegion(name);
+        if (region != nullptr)
+            return *region;
+
+        return getWholeTexture(ResourceManager::getTexture(ResourceManager::getTexturePath(name)));
+    }
+
+    TextureAtlas::Region TextureAtlas::getWholeTexture(const ResourceManager::TextureHandle &texture)
+    {
+        Region region{};
+        region.page = texture;
+
+        if (texture != nullptr)
+            SDL_QueryTexture(texture.get(), nullptr, nullptr, &region.source.w, &region.source.h);
+
+        region.originalWidth = region.source.w;
+        region.originalHeight = region.source.h;
+
+        return region;
+    }
+
+    bool TextureAtlas::load(const std::string &indexPath)
+    {
+        FRUITWORK_PROFILE_ZONE("TextureAtlas::load");
+
+        // read through the ResourceManager, so the index can come from the asset archive
+        SDL_RWops *file = ResourceManager::openFile(indexPath);
+        size_t size = 0;
+        char *contents = file != nullptr ? (char *) SDL_LoadFile_RW(file, &size, 1) : nullptr;
+        if (contents == nullptr)
+        {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to open texture atlas index: %s", indexPath.c_str());
+            return false;
+        }
+
+        std::istringstream index(std::string(contents, size));
+        SDL_free(contents);
+
+        // pages are stored next to the index
+        std::string directory = indexPath.substr(0, indexPath.find_last_of("/\\") + 1);
+
+        pages.clear();
+        regions.clear();
+
+        std::string line;
+        while (std::getline(index, line))
+        {
+            std::istringstream stream(line);
+            std::string type;
+            stream >> type;
+
+            if (type == "page")
+            {
+                std::string file;
+                stream >> file;
+                pages.push_back(ResourceManager::getTexture(directory + file));
+            }
+            else if (type == "region")
+            {
+                int page = -1;
+                Region region{};
+                stream >> page >> region.source.x >> region.source.y >> region.source.w >> region.source.h
+                       >> region.offset.x >> region.offset.y >> region.originalWidth >> region.originalHeight;
+
+                // the name is the rest of the line, it may contain spaces
+                std::string name;
+                if (stream)
+                    std::getline(stream >> std::ws, name);
+
+                if (name.empty() || page < 0 || page >= (int) pages.size())
+                {
+                    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Invalid texture atlas region: %s", line.c_str());
+                    continue;
+                }
+
+                region.page = pages[page];
+                regions[name] = region;
+            }
+        }
+
+        SDL_Log("Texture atlas loaded: %d images on %d page(s)", (int) regions.size(), (int) pages.size());
+
+        return true;
+    }
+
+    const TextureAtlas::Region *TextureAtlas::getRegion(const std::string &name) const
+    {
+        auto it = regions.find(name);
+        return it != regions.end() ? &it->second : nullptr;
+    }
+
+} // fruitwork
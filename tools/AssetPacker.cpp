@@ -0,0 +1,153 @@
+#include <SDL.h>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+#include "AssetArchive.h"
+
+/**
+ * Packs the files of one or more resource directories into a single archive, mapped by fruitwork::AssetArchive at startup.
+ * A file in a later directory replaces the file with the same path in an earlier one, so the project's resources override the engine's.
+ * Paths are stored as the engine asks for them, e.g. "resources/images/apple.png".
+ * Usage: asset_packer <output file> <resource directory>...
+ * @see fruitwork::AssetArchive for the archive format
+ */
+
+namespace fs = std::filesystem;
+
+using fruitwork::AssetArchive;
+
+/** Contents are aligned to this, so decoders reading them in place get aligned data. */
+static const Uint64 ALIGNMENT = 16;
+
+/** The directory the engine loads resources from, see constants::gResPath. */
+static const std::string RESOURCE_PREFIX = "resources/";
+
+struct File {
+    std::string path;
+    fs::path source;
+    AssetArchive::Entry entry{};
+};
+
+template<typename T>
+static void writeValue(std::ofstream &output, const T &value)
+{
+    output.write((const char *) &value, sizeof(T));
+}
+
+static void writePadding(std::ofstream &output, Uint64 to)
+{
+    static const char zeros[ALIGNMENT] = {};
+    Uint64 position = (Uint64) output.tellp();
+    output.write(zeros, (std::streamsize) ((to - position % to) % to));
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3)
+    {
+        SDL_Log("Usage: %s <output file> <resource directory>...", argv[0]);
+        return 1;
+    }
+
+    fs::path outputPath = argv[1];
+
+    // by path, so a later directory replaces the files of an earlier one and the archive comes out the same every time
+    std::map<std::string, fs::path> sources;
+    for (int i = 2; i < argc; i++)
+    {
+        fs::path directory = argv[i];
+        if (!fs::is_directory(directory))
+        {
+            SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "%s is not a directory, skipping it", directory.string().c_str());
+            continue;
+        }
+
+        for (const auto &entry: fs::recursive_directory_iterator(directory))
+        {
+            if (entry.is_regular_file())
+                sources[RESOURCE_PREFIX + fs::relative(entry.path(), directory).generic_string()] = entry.path();
+        }
+    }
+
+    std::vector<File> files;
+    for (const auto &source: sources)
+        files.push_back({source.first, source.second});
+
+    Uint32 slotCount = 16;
+    while (slotCount < files.size() * 2)
+        slotCount *= 2;
+
+    AssetArchive::Header header{AssetArchive::MAGIC, AssetArchive::VERSION, (Uint32) files.size(), slotCount};
+    std::vector<AssetArchive::Slot> slots(slotCount, 0);
+
+    Uint64 position = sizeof(header) + slotCount * sizeof(AssetArchive::Slot) + files.size() * sizeof(AssetArchive::Entry);
+    for (File &file: files)
+    {
+        file.entry.hash = AssetArchive::hash(file.path.data(), file.path.size());
+        file.entry.pathOffset = (Uint32) position;
+        file.entry.pathLength = (Uint32) file.path.size();
+        position += file.path.size();
+    }
+
+    for (File &file: files)
+    {
+        position = (position + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+        file.entry.offset = position;
+        file.entry.size = fs::file_size(file.source);
+        position += file.entry.size;
+    }
+
+    // linear probing, the table is at most half full
+    for (Uint32 i = 0; i < files.size(); i++)
+    {
+        Uint32 slot = (Uint32) files[i].entry.hash & (slotCount - 1);
+        while (slots[slot] != 0)
+            slot = (slot + 1) & (slotCount - 1);
+
+        slots[slot] = i + 1;
+    }
+
+    std::ofstream output(outputPath, std::ios::binary);
+    if (!output)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create %s", outputPath.string().c_str());
+        return 1;
+    }
+
+    writeValue(output, header);
+    output.write((const char *) slots.data(), (std::streamsize) (slots.size() * sizeof(AssetArchive::Slot)));
+
+    for (const File &file: files)
+        writeValue(output, file.entry);
+
+    for (const File &file: files)
+        output.write(file.path.data(), (std::streamsize) file.path.size());
+
+    std::vector<char> contents;
+    for (const File &file: files)
+    {
+        writePadding(output, ALIGNMENT);
+
+        std::ifstream input(file.source, std::ios::binary);
+        contents.assign(file.entry.size, 0);
+        if (!input.read(contents.data(), (std::streamsize) contents.size()))
+        {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to read %s", file.source.string().c_str());
+            return 1;
+        }
+
+        output.write(contents.data(), (std::streamsize) contents.size());
+    }
+
+    if (!output)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to write %s", outputPath.string().c_str());
+        return 1;
+    }
+
+    SDL_Log("Packed %d files into %s (%llu bytes)", (int) files.size(), outputPath.string().c_str(), (unsigned long long) position);
+
+    return 0;
+}
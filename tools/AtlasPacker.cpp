@@ -0,0 +1,219 @@
+#include <SDL.h>
+#include <SDL_image.h>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/**
+ * Packs every image of a directory into a few large texture atlas pages, and writes an index of where each image ended up.
+ * Transparent borders are trimmed, the index keeps the trimmed offsets so sprites are drawn exactly as before.
+ * Usage: atlas_packer <image directory> <output directory> [page size]
+ * @see fruitwork::TextureAtlas for the index format
+ */
+
+namespace fs = std::filesystem;
+
+/** Empty pixels between images, so scaled sprites don't bleed into their neighbours. */
+static const int PADDING = 2;
+
+struct Image {
+    std::string name;
+    SDL_Surface *surface;
+
+    /** The part of the image that is not fully transparent. */
+    SDL_Rect trimmed;
+
+    int page = -1;
+    SDL_Point position = {0, 0};
+};
+
+/** @return The smallest rect containing every pixel that is not fully transparent. */
+static SDL_Rect findOpaqueBounds(SDL_Surface *surface)
+{
+    int minX = surface->w, minY = surface->h, maxX = -1, maxY = -1;
+
+    SDL_LockSurface(surface);
+    for (int y = 0; y < surface->h; y++)
+    {
+        const Uint32 *row = (const Uint32 *) ((const Uint8 *) surface->pixels + y * surface->pitch);
+        for (int x = 0; x < surface->w; x++)
+        {
+            Uint8 r, g, b, a;
+            SDL_GetRGBA(row[x], surface->format, &r, &g, &b, &a);
+            if (a == 0)
+                continue;
+
+            minX = std::min(minX, x);
+            minY = std::min(minY, y);
+            maxX = std::max(maxX, x);
+            maxY = std::max(maxY, y);
+        }
+    }
+    SDL_UnlockSurface(surface);
+
+    // fully transparent, keep a single pixel so the image still has a region
+    if (maxX < 0)
+        return {0, 0, 1, 1};
+
+    return {minX, minY, maxX - minX + 1, maxY - minY + 1};
+}
+
+/**
+ * Places the images on shelves, tallest first: every image goes to the right of the previous one,
+ * and a new shelf (or page) is started when it doesn't fit.
+ * @return The amount of pages used.
+ */
+static int pack(std::vector<Image> &images, int pageSize)
+{
+    std::sort(images.begin(), images.end(), [](const Image &a, const Image &b)
+    {
+        return a.trimmed.h != b.trimmed.h ? a.trimmed.h > b.trimmed.h : a.name < b.name;
+    });
+
+    int page = 0;
+    int x = PADDING, y = PADDING, shelfHeight = 0;
+
+    for (Image &image: images)
+    {
+        int w = image.trimmed.w, h = image.trimmed.h;
+
+        if (w + 2 * PADDING > pageSize || h + 2 * PADDING > pageSize)
+        {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "%s (%dx%d) does not fit on a %dx%d page, skipping it",
+                         image.name.c_str(), w, h, pageSize, pageSize);
+            continue;
+        }
+
+        if (x + w + PADDING > pageSize)
+        {
+            // next shelf
+            x = PADDING;
+            y += shelfHeight + PADDING;
+            shelfHeight = 0;
+        }
+
+        if (y + h + PADDING > pageSize)
+        {
+            // next page
+            page++;
+            x = PADDING;
+            y = PADDING;
+            shelfHeight = 0;
+        }
+
+        image.page = page;
+        image.position = {x, y};
+
+        x += w + PADDING;
+        shelfHeight = std::max(shelfHeight, h);
+    }
+
+    return page + 1;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3)
+    {
+        SDL_Log("Usage: %s <image directory> <output directory> [page size]", argv[0]);
+        return 1;
+    }
+
+    const fs::path imageDir = argv[1];
+    const fs::path outputDir = argv[2];
+    const int pageSize = argc > 3 ? std::atoi(argv[3]) : 2048;
+
+    if (SDL_Init(0) != 0 || IMG_Init(IMG_INIT_PNG) == 0)
+    {
+        SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION, "Failed to initialize SDL_image: %s", IMG_GetError());
+        return 1;
+    }
+
+    std::vector<Image> images;
+
+    for (const fs::directory_entry &entry: fs::recursive_directory_iterator(imageDir))
+    {
+        if (!entry.is_regular_file() || entry.path().extension() != ".png")
+            continue;
+
+        SDL_Surface *loaded = IMG_Load(entry.path().string().c_str());
+        if (loaded == nullptr)
+        {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to load %s: %s", entry.path().string().c_str(), IMG_GetError());
+            continue;
+        }
+
+        // one known format makes reading and copying pixels simple
+        SDL_Surface *surface = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0);
+        SDL_FreeSurface(loaded);
+
+        if (surface == nullptr)
+        {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to convert %s: %s", entry.path().string().c_str(), SDL_GetError());
+            continue;
+        }
+
+        // names are relative to the image directory, the same names ResourceManager::getTexturePath takes
+        std::string name = fs::relative(entry.path(), imageDir).generic_string();
+        images.push_back({name, surface, findOpaqueBounds(surface)});
+    }
+
+    if (images.empty())
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "No images found in %s", imageDir.string().c_str());
+        return 1;
+    }
+
+    int pageCount = pack(images, pageSize);
+
+    fs::create_directories(outputDir);
+    std::ofstream index(outputDir / "atlas.txt");
+
+    for (int page = 0; page < pageCount; page++)
+    {
+        SDL_Surface *pageSurface = SDL_CreateRGBSurfaceWithFormat(0, pageSize, pageSize, 32, SDL_PIXELFORMAT_RGBA32);
+
+        for (Image &image: images)
+        {
+            if (image.page != page)
+                continue;
+
+            // copy the pixels as they are, including alpha
+            SDL_SetSurfaceBlendMode(image.surface, SDL_BLENDMODE_NONE);
+            SDL_Rect destination = {image.position.x, image.position.y, image.trimmed.w, image.trimmed.h};
+            SDL_BlitSurface(image.surface, &image.trimmed, pageSurface, &destination);
+        }
+
+        std::string pageName = "atlas-" + std::to_string(page) + ".png";
+        if (IMG_SavePNG(pageSurface, (outputDir / pageName).string().c_str()) != 0)
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to save %s: %s", pageName.c_str(), IMG_GetError());
+
+        SDL_FreeSurface(pageSurface);
+
+        index << "page " << pageName << "\n";
+    }
+
+    for (const Image &image: images)
+    {
+        if (image.page < 0)
+            continue;
+
+        // page x y w h offsetX offsetY originalW originalH name, the name last since it may contain spaces
+        index << "region " << image.page << " "
+              << image.position.x << " " << image.position.y << " " << image.trimmed.w << " " << image.trimmed.h << " "
+              << image.trimmed.x << " " << image.trimmed.y << " " << image.surface->w << " " << image.surface->h << " "
+              << image.name << "\n";
+    }
+
+    for (Image &image: images)
+        SDL_FreeSurface(image.surface);
+
+    SDL_Log("Packed %d images into %d page(s) in %s", (int) images.size(), pageCount, outputDir.string().c_str());
+
+    IMG_Quit();
+    SDL_Quit();
+
+    return 0;
+}